@@ -102,9 +102,104 @@
  * much appreciate getting credit if credit is due.  Thank you.
  */
 
+#if SSS_STATS
+#define _POSIX_C_SOURCE 200112L /* clock_gettime */
+#include <time.h>
+#endif
+#include <string.h>
 #include "sss.h"
 
-#define CON_TABLES 1 /* use generated tables */
+#ifndef CON_TABLES
+#define CON_TABLES 1 /* use generated tables, else sssInit fills them */
+#endif
+#ifndef LOG_TABLES
+#define LOG_TABLES 0 /* use 766 bytes of log and exp tables instead of the 64KB Cmt table */
+#endif
+#ifndef SIMD_KERNELS
+#define SIMD_KERNELS 1 /* use vector instructions when available */
+#endif
+#ifndef TILE_SIZE
+#define TILE_SIZE 8192 /* bytes of each buffer done at a time */
+#endif
+#ifndef NT_SIZE
+#define NT_SIZE (1 << 25) /* bytes of buffers at which outputs stored once bypass the cache */
+#endif
+#ifndef NT_ON
+#define NT_ON 5 /* most outputs streamed together, beyond the write combining buffers */
+#endif
+#ifndef NT_PF
+#define NT_PF 512 /* bytes ahead the inputs are prefetched then */
+#endif
+#ifndef SSS_STATS
+#define SSS_STATS 0 /* keep the counters of sssStats */
+#endif
+
+#if SIMD_KERNELS && defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define SIMD_X86 1
+#include <immintrin.h>
+#else
+#define SIMD_X86 0
+#endif
+
+#if SIMD_KERNELS && defined(__aarch64__) && defined(__ARM_NEON)
+#define SIMD_NEON 1
+#include <arm_neon.h>
+#else
+#define SIMD_NEON 0
+#endif
+
+#if SSS_STATS
+
+static struct sssStats Stats;
+
+#if defined(__GNUC__)
+#define STAT_ADD(f, n) __atomic_fetch_add(&Stats.f, (n), __ATOMIC_RELAXED)
+#define STAT_SET(f, n) __atomic_store_n(&Stats.f, (n), __ATOMIC_RELAXED)
+#define STAT_GET(f) __atomic_load_n(&Stats.f, __ATOMIC_RELAXED)
+#else /* not atomic, counts can be lost with threads */
+#define STAT_ADD(f, n) (Stats.f += (n))
+#define STAT_SET(f, n) (Stats.f = (n))
+#define STAT_GET(f) (Stats.f)
+#endif
+
+static unsigned long long
+now(
+  void
+){
+  struct timespec t;
+
+  clock_gettime(CLOCK_MONOTONIC, &t);
+  return (t.tv_sec * 1000000000ULL + t.tv_nsec);
+}
+
+static void
+tally(
+  unsigned int bk
+ ,unsigned long long ns
+ ,size_t ln
+){
+  STAT_ADD(kn, 1);
+  STAT_ADD(kt, now() - ns);
+  STAT_ADD(kb, ln);
+  STAT_ADD(bb[bk], ln);
+  STAT_SET(bk, bk);
+}
+
+#define STAT_BEGIN(ns) ((ns) = now())
+#define STAT_PLAN(ns) (STAT_ADD(pn, 1), STAT_ADD(pt, now() - (ns)))
+#define STAT_APPLY(bk, ns, ln) tally((bk), (ns), (ln))
+#define STAT_COPY(ln) STAT_ADD(cb, (ln))
+#define STAT_CHUNKS(n) STAT_SET(cn, (n))
+
+#else /* SSS_STATS */
+
+#define STAT_BEGIN(ns) ((ns) = 0)
+#define STAT_PLAN(ns) ((void)(ns))
+#define STAT_APPLY(bk, ns, ln) ((void)(ns), (void)(ln))
+#define STAT_COPY(ln) ((void)0)
+#define STAT_CHUNKS(n) ((void)0)
+
+#endif /* SSS_STATS */
 
 /* The below tables were generated with:
  *
@@ -142,10 +237,72 @@
  *    putchar('\n');
  * }
  * puts("};");
+ *
+ * and the log tables (LOG_TABLES 1) likewise with fillClt(Clt, Cet).
  */
 
 #if CON_TABLES
 
+#if LOG_TABLES
+
+/* Logarithm table for the Conway product, base 18 */
+static const unsigned char Clt[256] = {
+ 0,0,85,170,119,221,238,187,204,17,51,68,34,153,102,136
+,177,27,1,16,108,198,64,4,99,54,32,2,8,128,216,141
+,7,101,112,86,93,226,213,46,193,89,28,149,184,87,139,117
+,92,171,186,197,14,202,172,224,178,131,56,43,23,234,174,113
+,41,5,62,151,146,80,227,121,120,247,123,218,135,127,183,173
+,143,229,74,65,94,248,20,164,30,253,222,182,223,225,107,237
+,160,37,199,242,124,47,10,82,181,246,240,239,15,254,91,111
+,109,189,60,251,191,195,219,214,241,188,40,73,148,130,203,31
+,126,236,90,147,220,3,212,13,231,206,165,57,205,48,77,208
+,194,81,19,145,233,116,215,33,21,44,25,49,71,158,18,125
+,228,150,59,159,53,67,55,192,179,249,78,105,115,12,83,52
+,245,72,122,29,100,196,84,176,209,167,132,95,11,69,76,70
+,211,232,66,175,35,38,133,162,50,98,88,42,61,142,36,250
+,75,114,157,207,96,155,154,161,185,6,26,169,39,180,252,217
+,24,230,166,104,156,210,243,103,63,118,201,45,106,134,129,110
+,58,244,235,144,200,137,97,168,138,22,152,140,9,190,79,163
+};
+
+/* Exponent table for the Conway product, twice over so a sum of logarithms needs no reduction */
+static const unsigned char Cet[510] = {
+ 1,18,27,133,23,65,217,32,28,252,102,188,173,135,52,108
+,19,9,158,146,86,152,249,60,224,154,218,17,42,179,88,127
+,26,151,12,196,206,97,197,220,122,64,203,59,153,235,39,101
+,141,155,200,10,175,164,25,166,58,139,240,162,114,204,66,232
+,22,83,194,165,11,189,191,156,177,123,82,208,190,142,170,254
+,69,145,103,174,182,2,35,45,202,41,130,110,48,36,84,187
+,212,246,201,24,180,33,14,231,227,171,236,94,20,112,239,111
+,34,63,209,172,149,47,233,4,72,71,178,74,100,159,128,77
+,29,238,125,57,186,198,237,76,15,245,248,46,251,31,205,80
+,243,147,68,131,124,43,161,67,250,13,214,213,228,210,157,163
+,96,215,199,255,87,138,226,185,247,219,3,49,54,79,62,195
+,183,16,56,168,221,104,91,78,44,216,50,7,121,113,253,116
+,167,40,144,117,181,51,21,98,244,234,53,126,8,140,137,211
+,143,184,229,192,134,38,119,150,30,223,75,118,132,5,90,92
+,55,93,37,70,160,81,225,136,193,148,61,242,129,95,6,107
+,106,120,99,230,241,176,105,73,85,169,207,115,222,89,109,1
+,18,27,133,23,65,217,32,28,252,102,188,173,135,52,108,19
+,9,158,146,86,152,249,60,224,154,218,17,42,179,88,127,26
+,151,12,196,206,97,197,220,122,64,203,59,153,235,39,101,141
+,155,200,10,175,164,25,166,58,139,240,162,114,204,66,232,22
+,83,194,165,11,189,191,156,177,123,82,208,190,142,170,254,69
+,145,103,174,182,2,35,45,202,41,130,110,48,36,84,187,212
+,246,201,24,180,33,14,231,227,171,236,94,20,112,239,111,34
+,63,209,172,149,47,233,4,72,71,178,74,100,159,128,77,29
+,238,125,57,186,198,237,76,15,245,248,46,251,31,205,80,243
+,147,68,131,124,43,161,67,250,13,214,213,228,210,157,163,96
+,215,199,255,87,138,226,185,247,219,3,49,54,79,62,195,183
+,16,56,168,221,104,91,78,44,216,50,7,121,113,253,116,167
+,40,144,117,181,51,21,98,244,234,53,126,8,140,137,211,143
+,184,229,192,134,38,119,150,30,223,75,118,132,5,90,92,55
+,93,37,70,160,81,225,136,193,148,61,242,129,95,6,107,106
+,120,99,230,241,176,105,73,85,169,207,115,222,89,109
+};
+
+#else /* LOG_TABLES */
+
 /* Multiplication table for the Conway product up to 255 */
 static const unsigned char Cmt[256][256] = {{
  0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0
@@ -4521,15 +4678,13 @@ static const unsigned char Cit[256] = {
 ,51,188,86,111,166,233,157,45,47,148,231,172,105,83,183,48
 };
 
+#endif /* LOG_TABLES */
+
 #else /* CON_TABLES */
 
-static void
-fillCmt(
-  unsigned char cmt[][256]
-){
-  /* Multiplication table for the first 8 powers of two under Conway
-   * multiplication.  DO NOT CHANGE THIS UNDER ANY CIRCUMSTANCES. */
-  static const unsigned char cmp[8][8] = {
+/* Multiplication table for the first 8 powers of two under Conway
+ * multiplication.  DO NOT CHANGE THIS UNDER ANY CIRCUMSTANCES. */
+static const unsigned char Cmp[8][8] = {
    {   1,   2,   4,   8,  16,  32,  64, 128, }
   ,{   2,   3,   8,  12,  32,  48, 128, 192, }
   ,{   4,   8,   6,  11,  64, 128,  96, 176, }
@@ -4538,22 +4693,66 @@ fillCmt(
   ,{  32,  48, 128, 192,  44,  52, 141, 198, }
   ,{  64, 128,  96, 176,  75, 141, 103, 185, }
   ,{ 128, 192, 176, 208, 141, 198, 185, 222, }
-  };
-  unsigned int i;
-  unsigned int j;
+};
+
+static unsigned char
+conmul(
+  unsigned int i
+ ,unsigned int j
+){
   unsigned int k;
   unsigned int l;
   unsigned char n;
 
+  n = 0;
+  for (k = 0; i >> k; ++k)
+    for (l = 0; j >> l; ++l)
+      if (((i >> k) & 1) && ((j >> l) & 1))
+        n ^= Cmp[k][l];
+  return (n);
+}
+
+#if LOG_TABLES
+
+static void
+fillClt(
+  unsigned char clt[]
+ ,unsigned char cet[]
+){
+  unsigned int g;
+  unsigned int i;
+  unsigned char n;
+
+  /* the smallest generator, an element of order 255 */
+  for (g = 2;; ++g) {
+    for (n = g, i = 1; n != 1; ++i)
+      n = conmul(n, g);
+    if (i == 255)
+      break;
+  }
+  clt[0] = 0;
+  for (n = 1, i = 0; i < 255; ++i) {
+    cet[i] = cet[i + 255] = n;
+    clt[n] = i;
+    n = conmul(n, g);
+  }
+}
+
+static unsigned char Clt[256];
+static unsigned char Cet[510];
+
+#else /* LOG_TABLES */
+
+static void
+fillCmt(
+  unsigned char cmt[][256]
+){
+  unsigned int i;
+  unsigned int j;
+
   for (i = 0; i < 256; ++i)
-    for (j = 0; j < 256; ++j) {
-      n = 0;
-      for (k = 0; i >> k; ++k)
-        for (l = 0; j >> l; ++l)
-          if (((i >> k) & 1) && ((j >> l) & 1))
-            n ^= cmp[k][l];
-      cmt[i][j] = n;
-    }
+    for (j = 0; j < 256; ++j)
+      cmt[i][j] = conmul(i, j);
 }
 
 static void
@@ -4571,61 +4770,2059 @@ fillCit(
   }
 }
 
+static unsigned char Cmt[256][256];
+static unsigned char Cit[256];
+
+#endif /* LOG_TABLES */
+
 #endif /* CON_TABLES */
 
-void
-sss(
-  unsigned char *ip
- ,unsigned char *op
- ,unsigned char **iv
- ,unsigned char **ov
- ,unsigned int in
- ,unsigned int on
- ,unsigned int ln
-){
 #if !CON_TABLES
-  unsigned char Cmt[256][256];
-  unsigned char Cit[256];
+/* 0, 1 while a thread fills the tables, 2 once they are filled */
+static int Init;
+#if defined(__GNUC__)
+/* the first plan fills them if sssInit was not called, the thread that */
+/*   moves Init from 0 does and the others wait until it is 2 */
+#define INIT_GET() __atomic_load_n(&Init, __ATOMIC_ACQUIRE)
+#define INIT_SET() __atomic_store_n(&Init, 2, __ATOMIC_RELEASE)
+#define INIT() (INIT_GET() == 2 ? (void)0 : sssInit())
+#else /* not atomic, sssInit must be called before starting threads */
+#define INIT_GET() (Init)
+#define INIT_SET() (Init = 2)
+#define INIT() ((void)0)
+#endif
+#else
+#define INIT() ((void)0)
+#endif
+
+#if LOG_TABLES
+#define CMUL(a, b) ((a) && (b) ? Cet[Clt[a] + Clt[b]] : 0)
+#define CINV(a) ((a) ? Cet[255 - Clt[a]] : 0)
+#else
+#define CMUL(a, b) Cmt[a][b]
+#define CINV(a) Cit[a]
 #endif
-  unsigned char ic[256]; /* cross product of points in-in (xi-xj) */
-  unsigned char oc[256]; /* cross product of points out-in (zi-xj) */
-  unsigned int i;
-  unsigned int j;
-  unsigned int k;
-  unsigned char n;
 
+void
+sssInit(
+  void
+){
 #if !CON_TABLES
+#if defined(__GNUC__)
+  int e;
+
+  e = 0;
+  if (!__atomic_compare_exchange_n(&Init, &e, 1, 0, __ATOMIC_ACQUIRE, __ATOMIC_ACQUIRE)) {
+    while (INIT_GET() != 2);
+    return;
+  }
+#else
+  if (INIT_GET())
+    return;
+#endif
+#if LOG_TABLES
+  fillClt(Clt, Cet);
+#else
   fillCmt(Cmt);
   fillCit(Cmt, Cit);
 #endif
-  if (!ip || !op || !iv || !ov)
-    return;
-  /* do crosses */
-  for (i = 0; i < in; ++i) {
-    n = 1;
-    for (j = 0; j < in; ++j)
-      if (j != i)
-        n = Cmt[n][*(ip + i) ^ *(ip + j)];
-    ic[i] = n;
+  INIT_SET();
+#endif
+}
+
+unsigned char
+sssMul(
+  unsigned char a
+ ,unsigned char b
+){
+  INIT();
+  return (CMUL(a, b));
+}
+
+unsigned char
+sssInv(
+  unsigned char a
+){
+  INIT();
+  return (CINV(a));
+}
+
+/* Multiply by a constant c is linear, so:
+ *   c * x == c * (x & 15) ^ c * (x & 240)
+ * The vector kernels look up both halves with a 16 byte table shuffle.
+ *
+ * Each kernel does o = (a ? o : 0) ^ c * v over n rows of ln bytes,
+ * where the rows of o and v are os and vs bytes apart.  Vector kernels
+ * do the short end of a row through a buffer. */
+
+static void
+macScalar(
+  unsigned char *o
+ ,size_t os
+ ,const unsigned char *v
+ ,size_t vs
+ ,unsigned char c
+ ,size_t ln
+ ,size_t n
+ ,int a
+){
+#if LOG_TABLES
+  unsigned int l;
+#else
+  const unsigned char *m;
+#endif
+  size_t k;
+
+#if LOG_TABLES
+  l = Clt[c];
+  for (; n; --n, o += os, v += vs)
+    if (!c) {
+      if (!a)
+        for (k = 0; k < ln; ++k)
+          *(o + k) = 0;
+    } else if (a)
+      for (k = 0; k < ln; ++k)
+        *(o + k) ^= *(v + k) ? Cet[Clt[*(v + k)] + l] : 0;
+    else
+      for (k = 0; k < ln; ++k)
+        *(o + k) = *(v + k) ? Cet[Clt[*(v + k)] + l] : 0;
+#else
+  m = Cmt[c];
+  for (; n; --n, o += os, v += vs)
+    if (a)
+      for (k = 0; k < ln; ++k)
+        *(o + k) ^= *(m + *(v + k));
+    else
+      for (k = 0; k < ln; ++k)
+        *(o + k) = *(m + *(v + k));
+#endif
+}
+
+/* Constant time without tables: c * x is the xor of c * 2^b for the bits
+ * b of x, so 8 bytes at a time each bit b of every byte is spread to a
+ * mask for the byte (times 255) and the masks pick c * 2^b.  Nothing
+ * about the values changes which memory is read or how long it takes. */
+
+#define CT_LO 0x0101010101010101ULL
+#define CT_MUL(x, y) \
+  for (y = 0, b = 0; b < 8; ++b) \
+    y ^= ((x) >> b & CT_LO) * 0xff & m[b]
+
+static void
+macCt(
+  unsigned char *o
+ ,size_t os
+ ,const unsigned char *v
+ ,size_t vs
+ ,unsigned char c
+ ,size_t ln
+ ,size_t n
+ ,int a
+){
+  unsigned long long m[8];
+  unsigned long long x;
+  unsigned long long y;
+  unsigned int b;
+  size_t k;
+
+  for (b = 0; b < 8; ++b)
+    m[b] = CMUL(c, 1U << b) * CT_LO;
+  for (; n; --n, o += os, v += vs) {
+    for (k = 0; k + 8 <= ln; k += 8) {
+      memcpy(&x, v + k, 8);
+      CT_MUL(x, y);
+      if (a) {
+        memcpy(&x, o + k, 8);
+        y ^= x;
+      }
+      memcpy(o + k, &y, 8);
+    }
+    /* the short end */
+    if (k < ln) {
+      x = 0;
+      memcpy(&x, v + k, ln - k);
+      CT_MUL(x, y);
+      if (a) {
+        x = 0;
+        memcpy(&x, o + k, ln - k);
+        y ^= x;
+      }
+      memcpy(o + k, &y, ln - k);
+    }
   }
-  for (i = 0; i < on; ++i) {
-    n = 1;
-    for (j = 0; j < in; ++j)
-      n = Cmt[n][*(op + i) ^ *(ip + j)];
-    oc[i] = n;
+}
+
+#undef CT_MUL
+#undef CT_LO
+
+#if SIMD_X86 || SIMD_NEON
+
+/* low and high nibble products of c */
+static void
+nibbles(
+  unsigned char c
+ ,unsigned char *l
+ ,unsigned char *h
+){
+  unsigned int k;
+
+  /* the product is linear in k, so only the powers of 2 are multiplied */
+  *l = *h = 0;
+  for (k = 1; k < 16; ++k)
+    if (!(k & (k - 1))) {
+      *(l + k) = CMUL(c, k);
+      *(h + k) = CMUL(c, k << 4);
+    } else {
+      *(l + k) = *(l + (k & (k - 1))) ^ *(l + (k & -k));
+      *(h + k) = *(h + (k & (k - 1))) ^ *(h + (k & -k));
+    }
+}
+
+/* the short end of a row, b has been multiplied in place */
+static void
+tail(
+  unsigned char *o
+ ,const unsigned char *b
+ ,size_t ln
+ ,int a
+){
+  size_t k;
+
+  if (a)
+    for (k = 0; k < ln; ++k)
+      *(o + k) ^= *(b + k);
+  else
+    for (k = 0; k < ln; ++k)
+      *(o + k) = *(b + k);
+}
+
+#endif
+
+#if SIMD_X86
+
+#define MUL128(x) _mm_xor_si128(_mm_shuffle_epi8(tl, _mm_and_si128(x, mk)) \
+                               ,_mm_shuffle_epi8(th, _mm_and_si128(_mm_srli_epi16(x, 4), mk)))
+#define MUL256(x) _mm256_xor_si256(_mm256_shuffle_epi8(tl, _mm256_and_si256(x, mk)) \
+                                  ,_mm256_shuffle_epi8(th, _mm256_and_si256(_mm256_srli_epi16(x, 4), mk)))
+#define MUL512(x) _mm512_xor_si512(_mm512_shuffle_epi8(tl, _mm512_and_si512(x, mk)) \
+                                  ,_mm512_shuffle_epi8(th, _mm512_and_si512(_mm512_srli_epi16(x, 4), mk)))
+
+__attribute__((target("ssse3")))
+static void
+macSsse3(
+  unsigned char *o
+ ,size_t os
+ ,const unsigned char *v
+ ,size_t vs
+ ,unsigned char c
+ ,size_t ln
+ ,size_t n
+ ,int a
+){
+  unsigned char l[16];
+  unsigned char h[16];
+  unsigned char b[16] = {0};
+  __m128i tl;
+  __m128i th;
+  __m128i mk;
+  __m128i x;
+  size_t k;
+
+  nibbles(c, l, h);
+  tl = _mm_loadu_si128((const __m128i *)l);
+  th = _mm_loadu_si128((const __m128i *)h);
+  mk = _mm_set1_epi8(0x0f);
+  for (; n; --n, o += os, v += vs) {
+    for (k = 0; k + 16 <= ln; k += 16) {
+      x = _mm_loadu_si128((const __m128i *)(v + k));
+      x = MUL128(x);
+      if (a)
+        x = _mm_xor_si128(x, _mm_loadu_si128((const __m128i *)(o + k)));
+      _mm_storeu_si128((__m128i *)(o + k), x);
+    }
+    if (k < ln) {
+      tail(b, v + k, ln - k, 0);
+      x = _mm_loadu_si128((const __m128i *)b);
+      _mm_storeu_si128((__m128i *)b, MUL128(x));
+      tail(o + k, b, ln - k, a);
+    }
   }
-  /* do outputs */
-  for (k = 0; k < ln; ++k) {
-    for (i = 0; i < on; ++i) {
-      n = 0;
-      if (!oc[i]) {
-        for (j = 0; j < in; ++j)
-          if (*(op + i) == *(ip + j))
-            n = *(*(iv + j) + k);
-      } else
-        for (j = 0; j < in; ++j)
-          n ^= Cmt[*(*(iv + j) + k)][Cmt[oc[i]][Cit[Cmt[ic[j]][*(op + i) ^ *(ip + j)]]]];
-      *(*(ov + i) + k) = n;
+}
+
+__attribute__((target("avx2")))
+static void
+macAvx2(
+  unsigned char *o
+ ,size_t os
+ ,const unsigned char *v
+ ,size_t vs
+ ,unsigned char c
+ ,size_t ln
+ ,size_t n
+ ,int a
+){
+  unsigned char l[16];
+  unsigned char h[16];
+  unsigned char b[32] = {0};
+  __m256i tl;
+  __m256i th;
+  __m256i mk;
+  __m256i x;
+  size_t k;
+
+  nibbles(c, l, h);
+  tl = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i *)l));
+  th = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i *)h));
+  mk = _mm256_set1_epi8(0x0f);
+  for (; n; --n, o += os, v += vs) {
+    for (k = 0; k + 32 <= ln; k += 32) {
+      x = _mm256_loadu_si256((const __m256i *)(v + k));
+      x = MUL256(x);
+      if (a)
+        x = _mm256_xor_si256(x, _mm256_loadu_si256((const __m256i *)(o + k)));
+      _mm256_storeu_si256((__m256i *)(o + k), x);
+    }
+    if (k < ln) {
+      tail(b, v + k, ln - k, 0);
+      x = _mm256_loadu_si256((const __m256i *)b);
+      _mm256_storeu_si256((__m256i *)b, MUL256(x));
+      tail(o + k, b, ln - k, a);
+    }
+  }
+}
+
+__attribute__((target("avx512bw")))
+static void
+macAvx512(
+  unsigned char *o
+ ,size_t os
+ ,const unsigned char *v
+ ,size_t vs
+ ,unsigned char c
+ ,size_t ln
+ ,size_t n
+ ,int a
+){
+  unsigned char l[16];
+  unsigned char h[16];
+  __m512i tl;
+  __m512i th;
+  __m512i mk;
+  __m512i x;
+  __mmask64 m;
+  size_t k;
+
+  nibbles(c, l, h);
+  tl = _mm512_broadcast_i32x4(_mm_loadu_si128((const __m128i *)l));
+  th = _mm512_broadcast_i32x4(_mm_loadu_si128((const __m128i *)h));
+  mk = _mm512_set1_epi8(0x0f);
+  for (; n; --n, o += os, v += vs) {
+    for (k = 0; k + 64 <= ln; k += 64) {
+      x = _mm512_loadu_si512((const void *)(v + k));
+      x = MUL512(x);
+      if (a)
+        x = _mm512_xor_si512(x, _mm512_loadu_si512((const void *)(o + k)));
+      _mm512_storeu_si512((void *)(o + k), x);
+    }
+    /* masked loads and stores do the short end */
+    if (k < ln) {
+      m = ~0ULL >> (64 - (ln - k));
+      x = _mm512_maskz_loadu_epi8(m, v + k);
+      x = MUL512(x);
+      if (a)
+        x = _mm512_xor_si512(x, _mm512_maskz_loadu_epi8(m, o + k));
+      _mm512_mask_storeu_epi8(o + k, m, x);
+    }
+  }
+}
+
+#endif /* SIMD_X86 */
+
+#if SIMD_NEON
+
+#define MULNEON(x) veorq_u8(vqtbl1q_u8(tl, vandq_u8(x, mk)), vqtbl1q_u8(th, vshrq_n_u8(x, 4)))
+
+static void
+macNeon(
+  unsigned char *o
+ ,size_t os
+ ,const unsigned char *v
+ ,size_t vs
+ ,unsigned char c
+ ,size_t ln
+ ,size_t n
+ ,int a
+){
+  unsigned char l[16];
+  unsigned char h[16];
+  unsigned char b[16] = {0};
+  uint8x16_t tl;
+  uint8x16_t th;
+  uint8x16_t mk;
+  uint8x16_t x;
+  size_t k;
+
+  nibbles(c, l, h);
+  tl = vld1q_u8(l);
+  th = vld1q_u8(h);
+  mk = vdupq_n_u8(0x0f);
+  for (; n; --n, o += os, v += vs) {
+    for (k = 0; k + 16 <= ln; k += 16) {
+      x = vld1q_u8(v + k);
+      x = MULNEON(x);
+      if (a)
+        x = veorq_u8(x, vld1q_u8(o + k));
+      vst1q_u8(o + k, x);
+    }
+    if (k < ln) {
+      tail(b, v + k, ln - k, 0);
+      x = vld1q_u8(b);
+      vst1q_u8(b, MULNEON(x));
+      tail(o + k, b, ln - k, a);
+    }
+  }
+}
+
+#endif /* SIMD_NEON */
+
+typedef void (*mac_t)(unsigned char *, size_t, const unsigned char *, size_t, unsigned char, size_t, size_t, int);
+
+/* indexed by backend, 0 when not compiled in */
+static const mac_t Mac[] = {
+  macScalar
+#if SIMD_X86
+ ,macSsse3
+ ,macAvx2
+ ,macAvx512
+#else
+ ,0
+ ,0
+ ,0
+#endif
+#if SIMD_NEON
+ ,macNeon
+#else
+ ,0
+#endif
+ ,macCt
+};
+
+static int
+supported(
+  unsigned int bk
+){
+  if (bk >= sizeof (Mac) / sizeof (Mac[0]) || !Mac[bk])
+    return (0);
+#if SIMD_X86
+  switch (bk) {
+  case SSS_SSSE3:
+    return (__builtin_cpu_supports("ssse3"));
+  case SSS_AVX2:
+    return (__builtin_cpu_supports("avx2"));
+  case SSS_AVX512:
+    return (__builtin_cpu_supports("avx512bw"));
+  }
+#endif
+  return (1);
+}
+
+/* Fixed layouts: AVX2 kernels for common thresholds with the number of
+ * inputs and outputs known at compile time, so the loops unroll and the
+ * nibble tables stay in registers.  Each input is read, and split into
+ * nibbles, once and each output written once.  They do n rows of bytes
+ * of to of + ln, where the rows are is and os bytes apart.  (A scalar
+ * version was no faster than the general scalar kernel.) */
+
+#if defined(__GNUC__)
+#define INLINE inline __attribute__((always_inline))
+#else
+#define INLINE
+#endif
+
+#define FIX_IN 5 /* largest fixed layout */
+#define FIX_ON 9
+
+typedef void (*fix_t)(unsigned char (*)[256], unsigned char **, unsigned char **, size_t, size_t, size_t, size_t, size_t, int);
+
+#if SIMD_X86
+
+/* 32 bytes of each input at x[j] + xo to each output at y[i] + yo */
+/*   streamed past the cache if nt (y[i] + yo on 32 bytes) */
+__attribute__((target("avx2")))
+static INLINE void
+fixAvx2Step(
+  unsigned int I
+ ,unsigned int O
+ ,__m256i (*tl)[FIX_IN]
+ ,__m256i (*th)[FIX_IN]
+ ,unsigned char **x
+ ,size_t xo
+ ,unsigned char **y
+ ,size_t yo
+ ,int nt
+){
+  __m256i xl[FIX_IN];
+  __m256i xh[FIX_IN];
+  __m256i mk;
+  __m256i v;
+  unsigned int i;
+  unsigned int j;
+
+  mk = _mm256_set1_epi8(0x0f);
+  for (j = 0; j < I; ++j) {
+    if (nt)
+      _mm_prefetch((const char *)(*(x + j) + xo + NT_PF), _MM_HINT_T0);
+    v = _mm256_loadu_si256((const __m256i *)(*(x + j) + xo));
+    xl[j] = _mm256_and_si256(v, mk);
+    xh[j] = _mm256_and_si256(_mm256_srli_epi16(v, 4), mk);
+  }
+  for (i = 0; i < O; ++i) {
+    v = _mm256_setzero_si256();
+    for (j = 0; j < I; ++j)
+      v = _mm256_xor_si256(v, _mm256_xor_si256(_mm256_shuffle_epi8(tl[i][j], xl[j])
+                                              ,_mm256_shuffle_epi8(th[i][j], xh[j])));
+    if (nt)
+      _mm256_stream_si256((__m256i *)(*(y + i) + yo), v);
+    else
+      _mm256_storeu_si256((__m256i *)(*(y + i) + yo), v);
+  }
+}
+
+/* fewer than 32 bytes through buffers */
+__attribute__((target("avx2")))
+static INLINE void
+fixAvx2Part(
+  unsigned int I
+ ,unsigned int O
+ ,__m256i (*tl)[FIX_IN]
+ ,__m256i (*th)[FIX_IN]
+ ,unsigned char **iv
+ ,size_t io
+ ,unsigned char **ov
+ ,size_t oo
+ ,size_t ln
+){
+  unsigned char bi[FIX_IN][32] = {{0}};
+  unsigned char bo[FIX_ON][32];
+  unsigned char *pi[FIX_IN];
+  unsigned char *po[FIX_ON];
+  unsigned int i;
+  unsigned int j;
+
+  for (j = 0; j < I; ++j) {
+    tail(bi[j], *(iv + j) + io, ln, 0);
+    pi[j] = bi[j];
+  }
+  for (i = 0; i < O; ++i)
+    po[i] = bo[i];
+  fixAvx2Step(I, O, tl, th, pi, 0, po, 0, 0);
+  for (i = 0; i < O; ++i)
+    tail(*(ov + i) + oo, bo[i], ln, 0);
+}
+
+__attribute__((target("avx2")))
+static INLINE void
+fixAvx2(
+  unsigned int I
+ ,unsigned int O
+ ,unsigned char (*cf)[256]
+ ,unsigned char **iv
+ ,unsigned char **ov
+ ,size_t of
+ ,size_t ln
+ ,size_t is
+ ,size_t os
+ ,size_t n
+ ,int nt
+){
+  __m256i tl[FIX_ON][FIX_IN];
+  __m256i th[FIX_ON][FIX_IN];
+  unsigned char l[16];
+  unsigned char h[16];
+  unsigned int i;
+  unsigned int j;
+  size_t r;
+  size_t k;
+  size_t e;
+
+  for (i = 0; i < O; ++i)
+    for (j = 0; j < I; ++j) {
+      nibbles(cf[i][j], l, h);
+      tl[i][j] = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i *)l));
+      th[i][j] = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i *)h));
+    }
+  for (r = 0; r < n; ++r) {
+    k = of;
+    /* streaming, the start through buffers to where the outputs are on 32 bytes */
+    if (nt && (e = -(size_t)(*ov + r * os + k) & 31)) {
+      e = e < ln ? e : ln;
+      fixAvx2Part(I, O, tl, th, iv, r * is + k, ov, r * os + k, e);
+      k += e;
+    }
+    for (; k + 32 <= of + ln; k += 32)
+      fixAvx2Step(I, O, tl, th, iv, r * is + k, ov, r * os + k, nt);
+    /* the short end through buffers */
+    if (k < of + ln)
+      fixAvx2Part(I, O, tl, th, iv, r * is + k, ov, r * os + k, of + ln - k);
+  }
+  if (nt)
+    _mm_sfence();
+}
+
+#define FIX_AVX2(I, O) \
+__attribute__((target("avx2"))) \
+static void \
+fixAvx2##I##_##O( \
+  unsigned char (*cf)[256] \
+ ,unsigned char **iv \
+ ,unsigned char **ov \
+ ,size_t of \
+ ,size_t ln \
+ ,size_t is \
+ ,size_t os \
+ ,size_t n \
+ ,int nt \
+){ \
+  fixAvx2(I, O, cf, iv, ov, of, ln, is, os, n, nt); \
+}
+
+FIX_AVX2(2, 3)
+FIX_AVX2(3, 5)
+FIX_AVX2(5, 9)
+
+#undef FIX_AVX2
+
+#endif /* SIMD_X86 */
+
+static const struct {
+  unsigned int in;
+  unsigned int on;
+  fix_t fn; /* for the AVX2 and AVX-512 backends */
+} Fix[] = {
+#if SIMD_X86
+  { 2, 3, fixAvx22_3 }
+ ,{ 3, 5, fixAvx23_5 }
+ ,{ 5, 9, fixAvx25_9 }
+#else
+  { 0, 0, 0 }
+#endif
+};
+
+/* fixed layout kernel for a plan, 0 if none */
+static fix_t
+fixed(
+  struct sssPlan *pl
+){
+  return (pl->fx ? Fix[pl->fx - 1].fn : 0);
+}
+
+/* one output of up to ONE_IN inputs, each vector of the output summed */
+/*   in a register over the inputs and stored once (added to it if a) */
+#define ONE_IN 16 /* inputs read together, more are done in groups a tile at a time */
+
+typedef void (*one_t)(const unsigned char *, unsigned char **, unsigned char *, unsigned int, size_t, size_t, int, int);
+
+#if SIMD_X86
+
+/* the short ends 16 bytes at a time with the kernel's nibble tables, */
+/*   a partial one through a zeroed buffer so no table is indexed by data */
+__attribute__((target("ssse3")))
+static void
+oneTail(
+  __m128i (*tb)[2]
+ ,unsigned char **iv
+ ,unsigned char *o
+ ,unsigned int in
+ ,size_t of
+ ,size_t ln
+ ,int a
+){
+  unsigned char b[16] = {0};
+  __m128i tl;
+  __m128i th;
+  __m128i mk;
+  __m128i x;
+  __m128i s;
+  unsigned int j;
+  size_t k;
+  size_t r;
+
+  mk = _mm_set1_epi8(0x0f);
+  for (k = of; k < of + ln; k += r) {
+    r = of + ln - k < 16 ? of + ln - k : 16;
+    s = _mm_setzero_si128();
+    for (j = 0; j < in; ++j) {
+      tl = tb[j][0];
+      th = tb[j][1];
+      tail(b, *(iv + j) + k, r, 0);
+      x = _mm_loadu_si128((const __m128i *)b);
+      s = _mm_xor_si128(s, MUL128(x));
     }
+    _mm_storeu_si128((__m128i *)b, s);
+    tail(o + k, b, r, a);
   }
 }
+
+__attribute__((target("ssse3")))
+static void
+oneSsse3(
+  const unsigned char *cf
+ ,unsigned char **iv
+ ,unsigned char *o
+ ,unsigned int in
+ ,size_t of
+ ,size_t ln
+ ,int a
+ ,int nt
+){
+  __m128i tb[ONE_IN][2];
+  __m128i tl;
+  __m128i th;
+  __m128i mk;
+  __m128i x;
+  __m128i y;
+  __m128i s;
+  __m128i t;
+  unsigned int j;
+  size_t k;
+  size_t h;
+
+  for (j = 0; j < in; ++j)
+    nibbles(*(cf + j), (unsigned char *)&tb[j][0], (unsigned char *)&tb[j][1]);
+  mk = _mm_set1_epi8(0x0f);
+  k = of;
+  if (nt) {
+    /* to where the output can be streamed */
+    h = -(size_t)(o + k) & 15;
+    h = h < ln ? h : ln;
+    oneTail(tb, iv, o, in, k, h, a);
+    k += h;
+  }
+  for (; k + 32 <= of + ln; k += 32) {
+    if (a) {
+      s = _mm_loadu_si128((const __m128i *)(o + k));
+      t = _mm_loadu_si128((const __m128i *)(o + k + 16));
+    } else
+      s = t = _mm_setzero_si128();
+    for (j = 0; j < in; ++j) {
+      tl = tb[j][0];
+      th = tb[j][1];
+      if (nt)
+        _mm_prefetch((const char *)(*(iv + j) + k + NT_PF), _MM_HINT_T0);
+      x = _mm_loadu_si128((const __m128i *)(*(iv + j) + k));
+      y = _mm_loadu_si128((const __m128i *)(*(iv + j) + k + 16));
+      s = _mm_xor_si128(s, MUL128(x));
+      t = _mm_xor_si128(t, MUL128(y));
+    }
+    if (nt) {
+      _mm_stream_si128((__m128i *)(o + k), s);
+      _mm_stream_si128((__m128i *)(o + k + 16), t);
+    } else {
+      _mm_storeu_si128((__m128i *)(o + k), s);
+      _mm_storeu_si128((__m128i *)(o + k + 16), t);
+    }
+  }
+  if (nt)
+    _mm_sfence();
+  oneTail(tb, iv, o, in, k, of + ln - k, a);
+}
+
+__attribute__((target("avx2")))
+static void
+oneAvx2(
+  const unsigned char *cf
+ ,unsigned char **iv
+ ,unsigned char *o
+ ,unsigned int in
+ ,size_t of
+ ,size_t ln
+ ,int a
+ ,int nt
+){
+  __m128i tb[ONE_IN][2];
+  __m256i tl;
+  __m256i th;
+  __m256i mk;
+  __m256i x;
+  __m256i y;
+  __m256i s;
+  __m256i t;
+  unsigned int j;
+  size_t k;
+  size_t h;
+
+  for (j = 0; j < in; ++j)
+    nibbles(*(cf + j), (unsigned char *)&tb[j][0], (unsigned char *)&tb[j][1]);
+  mk = _mm256_set1_epi8(0x0f);
+  k = of;
+  if (nt) {
+    /* to where the output can be streamed */
+    h = -(size_t)(o + k) & 31;
+    h = h < ln ? h : ln;
+    oneTail(tb, iv, o, in, k, h, a);
+    k += h;
+  }
+  for (; k + 64 <= of + ln; k += 64) {
+    if (a) {
+      s = _mm256_loadu_si256((const __m256i *)(o + k));
+      t = _mm256_loadu_si256((const __m256i *)(o + k + 32));
+    } else
+      s = t = _mm256_setzero_si256();
+    for (j = 0; j < in; ++j) {
+      tl = _mm256_broadcastsi128_si256(tb[j][0]);
+      th = _mm256_broadcastsi128_si256(tb[j][1]);
+      if (nt)
+        _mm_prefetch((const char *)(*(iv + j) + k + NT_PF), _MM_HINT_T0);
+      x = _mm256_loadu_si256((const __m256i *)(*(iv + j) + k));
+      y = _mm256_loadu_si256((const __m256i *)(*(iv + j) + k + 32));
+      s = _mm256_xor_si256(s, MUL256(x));
+      t = _mm256_xor_si256(t, MUL256(y));
+    }
+    if (nt) {
+      _mm256_stream_si256((__m256i *)(o + k), s);
+      _mm256_stream_si256((__m256i *)(o + k + 32), t);
+    } else {
+      _mm256_storeu_si256((__m256i *)(o + k), s);
+      _mm256_storeu_si256((__m256i *)(o + k + 32), t);
+    }
+  }
+  if (nt)
+    _mm_sfence();
+  oneTail(tb, iv, o, in, k, of + ln - k, a);
+}
+
+__attribute__((target("avx512bw")))
+static void
+oneAvx512(
+  const unsigned char *cf
+ ,unsigned char **iv
+ ,unsigned char *o
+ ,unsigned int in
+ ,size_t of
+ ,size_t ln
+ ,int a
+ ,int nt
+){
+  __m128i tb[ONE_IN][2];
+  __m512i tl;
+  __m512i th;
+  __m512i mk;
+  __m512i x;
+  __m512i y;
+  __m512i s;
+  __m512i t;
+  unsigned int j;
+  size_t k;
+  size_t h;
+
+  for (j = 0; j < in; ++j)
+    nibbles(*(cf + j), (unsigned char *)&tb[j][0], (unsigned char *)&tb[j][1]);
+  mk = _mm512_set1_epi8(0x0f);
+  k = of;
+  if (nt) {
+    /* to where the output can be streamed */
+    h = -(size_t)(o + k) & 63;
+    h = h < ln ? h : ln;
+    oneTail(tb, iv, o, in, k, h, a);
+    k += h;
+  }
+  for (; k + 128 <= of + ln; k += 128) {
+    if (a) {
+      s = _mm512_loadu_si512((const void *)(o + k));
+      t = _mm512_loadu_si512((const void *)(o + k + 64));
+    } else
+      s = t = _mm512_setzero_si512();
+    for (j = 0; j < in; ++j) {
+      tl = _mm512_broadcast_i32x4(tb[j][0]);
+      th = _mm512_broadcast_i32x4(tb[j][1]);
+      if (nt) {
+        _mm_prefetch((const char *)(*(iv + j) + k + NT_PF), _MM_HINT_T0);
+        _mm_prefetch((const char *)(*(iv + j) + k + NT_PF + 64), _MM_HINT_T0);
+      }
+      x = _mm512_loadu_si512((const void *)(*(iv + j) + k));
+      y = _mm512_loadu_si512((const void *)(*(iv + j) + k + 64));
+      s = _mm512_xor_si512(s, MUL512(x));
+      t = _mm512_xor_si512(t, MUL512(y));
+    }
+    if (nt) {
+      _mm512_stream_si512((void *)(o + k), s);
+      _mm512_stream_si512((void *)(o + k + 64), t);
+    } else {
+      _mm512_storeu_si512((void *)(o + k), s);
+      _mm512_storeu_si512((void *)(o + k + 64), t);
+    }
+  }
+  if (nt)
+    _mm_sfence();
+  oneTail(tb, iv, o, in, k, of + ln - k, a);
+}
+
+#endif /* SIMD_X86 */
+
+/* indexed by backend, 0 when there is none */
+static const one_t One[] = {
+  0
+#if SIMD_X86
+ ,oneSsse3
+ ,oneAvx2
+ ,oneAvx512
+#else
+ ,0
+ ,0
+ ,0
+#endif
+ ,0
+ ,0
+};
+
+int
+sssBackend(
+  struct sssPlan *pl
+ ,unsigned int bk
+){
+  unsigned int i;
+
+  if (!pl)
+    return (-1);
+  if (bk == SSS_AUTO) {
+    /* the fastest, which is a vector kernel (constant time too) or the tables */
+    for (bk = SSS_NEON; !supported(bk); --bk);
+  } else if (!supported(bk))
+    return (-1);
+  pl->bk = bk;
+  /* plans with outputs that are inputs use the general kernels */
+  for (pl->fx = 0, i = 0; i < pl->on && !pl->pt[i]; ++i);
+  if (i == pl->on && (bk == SSS_AVX2 || bk == SSS_AVX512))
+    for (i = 0; i < sizeof (Fix) / sizeof (Fix[0]); ++i)
+      if (Fix[i].fn && Fix[i].in == pl->in && Fix[i].on == pl->on)
+        pl->fx = i + 1;
+  return (0);
+}
+
+/* the cross products of the points, ic[i] of input i with the other */
+/*   inputs (xi-xj) and oc[i] of output i with the inputs (zi-xj) */
+static void
+crosses(
+  const unsigned char *ip
+ ,const unsigned char *op
+ ,unsigned int in
+ ,unsigned int on
+ ,unsigned char *ic
+ ,unsigned char *oc
+){
+  unsigned int i;
+  unsigned int j;
+  unsigned char n;
+
+  for (i = 0; i < in; ++i) {
+    n = 1;
+    for (j = 0; j < in; ++j)
+      if (j != i)
+        n = CMUL(n, *(ip + i) ^ *(ip + j));
+    *(ic + i) = n;
+  }
+  for (i = 0; i < on; ++i) {
+    n = 1;
+    for (j = 0; j < in; ++j)
+      n = CMUL(n, *(op + i) ^ *(ip + j));
+    *(oc + i) = n;
+  }
+}
+
+/* the coefficients of the inputs for output point p, with cross c not 0 */
+static void
+row(
+  unsigned char *cf
+ ,const unsigned char *ip
+ ,const unsigned char *ic
+ ,unsigned int in
+ ,unsigned char p
+ ,unsigned char c
+){
+  unsigned int j;
+
+  for (j = 0; j < in; ++j)
+    *(cf + j) = CMUL(c, CINV(CMUL(*(ic + j), p ^ *(ip + j))));
+}
+
+static int
+plan(
+  struct sssPlan *pl
+ ,unsigned char *ip
+ ,unsigned char *op
+ ,unsigned int in
+ ,unsigned int on
+){
+  unsigned char ic[256]; /* cross product of points in-in (xi-xj) */
+  unsigned char oc[256]; /* cross product of points out-in (zi-xj) */
+  unsigned int i;
+  unsigned int j;
+
+  INIT();
+  if (!pl || !ip || !op || in > 256 || on > 256)
+    return (-1);
+  for (i = 0; i < in; ++i)
+    for (j = i + 1; j < in; ++j)
+      if (*(ip + i) == *(ip + j))
+        return (-1);
+  pl->in = in;
+  pl->on = on;
+  crosses(ip, op, in, on, ic, oc);
+  /* do coefficients */
+  for (i = 0; i < on; ++i) {
+    pl->pt[i] = 0;
+    if (!oc[i]) {
+      for (j = 0; j < in; ++j) {
+        pl->cf[i][j] = 0;
+        if (*(op + i) == *(ip + j))
+          pl->pt[i] = j + 1;
+      }
+    } else
+      row(pl->cf[i], ip, ic, in, *(op + i), oc[i]);
+  }
+  sssBackend(pl, SSS_AUTO);
+  return (0);
+}
+
+int
+sssPlan(
+  struct sssPlan *pl
+ ,unsigned char *ip
+ ,unsigned char *op
+ ,unsigned int in
+ ,unsigned int on
+){
+  unsigned long long ns;
+
+  STAT_BEGIN(ns);
+  if (plan(pl, ip, op, in, on))
+    return (-1);
+  STAT_PLAN(ns);
+  return (0);
+}
+
+int
+sssPlanPoly(
+  struct sssPlan *pl
+ ,unsigned char *op
+ ,unsigned int in
+ ,unsigned int on
+){
+  unsigned int i;
+  unsigned int j;
+  unsigned char n;
+  unsigned long long ns;
+
+  INIT();
+  STAT_BEGIN(ns);
+  if (!pl || !op || in > 256 || on > 256)
+    return (-1);
+  pl->in = in;
+  pl->on = on;
+  /* the powers of each point are the coefficients, so the polynomial is */
+  /* evaluated term by term, each input one multiply by a constant and add */
+  for (i = 0; i < on; ++i) {
+    pl->pt[i] = 0;
+    for (n = 1, j = 0; j < in; ++j) {
+      pl->cf[i][j] = n;
+      n = CMUL(n, *(op + i));
+    }
+  }
+  sssBackend(pl, SSS_AUTO);
+  STAT_PLAN(ns);
+  return (0);
+}
+
+int
+sssPlanCoef(
+  struct sssPlan *pl
+ ,unsigned char *ip
+ ,unsigned int in
+){
+  unsigned char pc[257]; /* coefficients of the product of (X-xj) */
+  unsigned char bc[256]; /* product without (X-xj) */
+  unsigned int i;
+  unsigned int j;
+  unsigned int k;
+  unsigned char n;
+  unsigned long long ns;
+
+  INIT();
+  STAT_BEGIN(ns);
+  if (!pl || !ip || in > 256)
+    return (-1);
+  for (i = 0; i < in; ++i)
+    for (j = i + 1; j < in; ++j)
+      if (*(ip + i) == *(ip + j))
+        return (-1);
+  pl->in = in;
+  pl->on = in;
+  for (pc[0] = 1, k = 1; k <= in; ++k)
+    pc[k] = 0;
+  for (j = 0; j < in; ++j) {
+    for (k = j + 1; k; --k)
+      pc[k] = pc[k - 1] ^ CMUL(pc[k], *(ip + j));
+    pc[0] = CMUL(pc[0], *(ip + j));
+  }
+  /* Pj is the product divided by (X-xj) and by its value at xj */
+  for (j = 0; j < in; ++j) {
+    bc[in - 1] = pc[in];
+    for (k = in - 1; k > 0; --k)
+      bc[k - 1] = pc[k] ^ CMUL(*(ip + j), bc[k]);
+    for (n = 1, k = 0; k < in; ++k)
+      if (k != j)
+        n = CMUL(n, *(ip + j) ^ *(ip + k));
+    for (n = CINV(n), i = 0; i < in; ++i)
+      pl->cf[i][j] = CMUL(bc[i], n);
+  }
+  for (i = 0; i < in; ++i)
+    pl->pt[i] = 0;
+  sssBackend(pl, SSS_AUTO);
+  STAT_PLAN(ns);
+  return (0);
+}
+
+int
+sssPlanReshare(
+  struct sssPlan *pl
+ ,unsigned char *ip
+ ,unsigned char *op
+ ,unsigned int in
+ ,unsigned int tn
+ ,unsigned int on
+){
+  unsigned char rc[256]; /* coefficients recovering the secret */
+  unsigned int i;
+  unsigned int j;
+  unsigned char n;
+  unsigned char z;
+  unsigned long long ns;
+
+  STAT_BEGIN(ns);
+  if (!pl || !ip || !op || tn < 2 || in + tn - 1 > 256 || on > 256)
+    return (-1);
+  for (i = 0; i < on; ++i)
+    if (!*(op + i))
+      return (-1);
+  z = 0;
+  if (plan(pl, ip, &z, in, 1))
+    return (-1);
+  for (j = 0; j < in; ++j)
+    rc[j] = pl->pt[0] ? pl->pt[0] - 1 == j : pl->cf[0][j];
+  pl->in = in + tn - 1;
+  pl->on = on;
+  /* each new share is the secret interpolated from the old ones */
+  /* plus the random coefficients times the powers of its point */
+  for (i = 0; i < on; ++i) {
+    pl->pt[i] = 0;
+    for (j = 0; j < in; ++j)
+      pl->cf[i][j] = rc[j];
+    for (n = *(op + i); j < pl->in; ++j) {
+      pl->cf[i][j] = n;
+      n = CMUL(n, *(op + i));
+    }
+  }
+  sssBackend(pl, SSS_AUTO);
+  STAT_PLAN(ns);
+  return (0);
+}
+
+int
+sssPlanCheck(
+  struct sssPlan *pl
+ ,unsigned char *ip
+ ,unsigned int in
+ ,unsigned int tn
+){
+  unsigned int i;
+  unsigned int j;
+  unsigned long long ns;
+
+  STAT_BEGIN(ns);
+  if (!pl || !ip || !tn || tn >= in || in > 256)
+    return (-1);
+  for (i = 0; i < in; ++i)
+    for (j = i + 1; j < in; ++j)
+      if (*(ip + i) == *(ip + j))
+        return (-1);
+  /* the first tn shares give the others, less the others */
+  if (plan(pl, ip, ip + tn, tn, in - tn))
+    return (-1);
+  for (i = 0; i < in - tn; ++i)
+    for (j = tn; j < in; ++j)
+      pl->cf[i][j] = j - tn == i;
+  pl->in = in;
+  sssBackend(pl, pl->bk);
+  STAT_PLAN(ns);
+  return (0);
+}
+
+int
+sssPlanDecode(
+  struct sssDecode *dc
+ ,unsigned char *ip
+ ,unsigned char *op
+ ,unsigned int in
+ ,unsigned int tn
+ ,unsigned int on
+){
+  struct sssPlan *pl;
+  unsigned int sn;
+  unsigned int i;
+  unsigned int j;
+  unsigned long long ns;
+
+  STAT_BEGIN(ns);
+  if (!dc || !ip || !op || !tn || tn > in || in > 256 || on > 256 - (in - tn))
+    return (-1);
+  for (i = 0; i < in; ++i)
+    for (j = i + 1; j < in; ++j)
+      if (*(ip + i) == *(ip + j))
+        return (-1);
+  pl = &dc->pl;
+  sn = in - tn;
+  /* the outputs from the first tn shares, then the syndromes of the others */
+  if (sn) {
+    plan(pl, ip, ip + tn, tn, sn);
+    memmove(pl->cf[on], pl->cf[0], sn * sizeof (pl->cf[0]));
+  }
+  plan(pl, ip, op, tn, on);
+  for (i = on; i < on + sn; ++i) {
+    pl->pt[i] = 0;
+    for (j = tn; j < in; ++j)
+      pl->cf[i][j] = j - tn == i - on;
+  }
+  for (i = 0; i < on; ++i)
+    for (j = tn; j < in; ++j)
+      pl->cf[i][j] = 0;
+  pl->in = in;
+  pl->on = on + sn;
+  sssBackend(pl, pl->bk);
+  memcpy(dc->ip, ip, in);
+  memcpy(dc->op, op, on);
+  dc->tn = tn;
+  dc->on = on;
+  STAT_PLAN(ns);
+  return (0);
+}
+
+/* whether outputs stored once are streamed past the cache, all on */
+/*   the same 32 byte alignment */
+static int
+streamed(
+  unsigned char **ov
+ ,unsigned int in
+ ,unsigned int on
+ ,size_t ln
+){
+  unsigned int i;
+  int nt;
+
+  nt = on <= NT_ON && ln >= NT_SIZE / (in + on);
+  for (i = 1; nt && i < on; ++i)
+    nt = !(((size_t)*(ov + i) ^ (size_t)*ov) & 31);
+  return (nt);
+}
+
+/* one output from in of at least 2 inputs in one pass, or with more */
+/*   than ONE_IN a tile and ONE_IN of them at a time */
+static void
+oneRow(
+  one_t one
+ ,const unsigned char *cf
+ ,unsigned char **iv
+ ,unsigned char *o
+ ,unsigned int in
+ ,size_t of
+ ,size_t ln
+){
+  unsigned int j;
+  size_t k;
+  size_t t;
+
+  if (in <= ONE_IN) {
+    one(cf, iv, o, in, of, ln, 0, streamed(&o, in, 1, ln));
+    return;
+  }
+  for (k = of; k < of + ln; k += t) {
+    t = of + ln - k < TILE_SIZE ? of + ln - k : TILE_SIZE;
+    for (j = 0; j < in; j += ONE_IN)
+      one(cf + j, iv + j, o, in - j < ONE_IN ? in - j : ONE_IN, k, t, j != 0, 0);
+  }
+}
+
+/* do bytes of to of + ln */
+static void
+apply(
+  struct sssPlan *pl
+ ,unsigned char **iv
+ ,unsigned char **ov
+ ,size_t of
+ ,size_t ln
+){
+  fix_t fix;
+  mac_t mac;
+  one_t one;
+  unsigned int i;
+  unsigned int j;
+  size_t k;
+  size_t t;
+
+  /* the outputs are stored once, so when large are streamed if they line up */
+  if ((fix = fixed(pl))) {
+    fix(pl->cf, iv, ov, of, ln, 0, 0, 1, streamed(ov, pl->in, pl->on, ln));
+    return;
+  }
+  /* a recovery */
+  if (pl->on == 1 && !pl->pt[0] && pl->in > 1 && (one = One[pl->bk])) {
+    oneRow(one, pl->cf[0], iv, *ov, pl->in, of, ln);
+    return;
+  }
+  /* outputs that are inputs are a copy, or nothing if given the input buffer */
+  for (i = 0; i < pl->on; ++i)
+    if (pl->pt[i] && *(ov + i) != *(iv + pl->pt[i] - 1)) {
+      memcpy(*(ov + i) + of, *(iv + pl->pt[i] - 1) + of, ln);
+      STAT_COPY(ln);
+    } else if (!pl->pt[i] && !pl->in)
+      memset(*(ov + i) + of, 0, ln);
+  if (!pl->in)
+    return;
+  mac = Mac[pl->bk];
+  /* do outputs a tile at a time so the output tile stays in cache across the inputs */
+  for (k = of; k < of + ln; k += t) {
+    t = of + ln - k < TILE_SIZE ? of + ln - k : TILE_SIZE;
+    for (i = 0; i < pl->on; ++i)
+      if (!pl->pt[i])
+        for (j = 0; j < pl->in; ++j)
+          if (!j || pl->cf[i][j]) /* nothing to add */
+            mac(*(ov + i) + k, 0, *(iv + j) + k, 0, pl->cf[i][j], t, 1, j);
+  }
+}
+
+void
+sssApply(
+  struct sssPlan *pl
+ ,unsigned char **iv
+ ,unsigned char **ov
+ ,size_t ln
+){
+  unsigned long long ns;
+
+  if (!pl || !iv || !ov)
+    return;
+  STAT_BEGIN(ns);
+  apply(pl, iv, ov, 0, ln);
+  STAT_APPLY(pl->bk, ns, ln);
+}
+
+/* the share of a byte with syndrome s (of pl->on bytes rows apart) */
+/*   if one share being wrong explains it, else ~0 */
+static unsigned int
+locate(
+  struct sssPlan *pl
+ ,const unsigned char *s
+ ,size_t rs
+){
+  unsigned int tn;
+  unsigned int i;
+  unsigned int j;
+  unsigned int n;
+  unsigned char e;
+
+  tn = pl->in - pl->on;
+  for (n = 0, j = 0, i = 0; i < pl->on; ++i)
+    if (*(s + i * rs))
+      ++n, j = i;
+  /* one of the others is off by the syndrome */
+  if (n == 1)
+    return (pl->on > 1 ? tn + j : ~0U);
+  /* one of the first is off by e, when each syndrome is its coefficient times e */
+  if (n == pl->on)
+    for (j = 0; j < tn; ++j) {
+      e = CMUL(*s, CINV(pl->cf[0][j]));
+      for (i = 1; i < pl->on && *(s + i * rs) == CMUL(pl->cf[i][j], e); ++i);
+      if (i == pl->on)
+        return (j);
+    }
+  return (~0U);
+}
+
+size_t
+sssCheck(
+  struct sssPlan *pl
+ ,unsigned char **iv
+ ,size_t ln
+ ,size_t bs
+ ,unsigned int *bd
+){
+  unsigned char sb[TILE_SIZE];
+  unsigned char *sv[256];
+  unsigned char *vv[256];
+  unsigned long long ns;
+  unsigned int i;
+  unsigned int j;
+  size_t nb;
+  size_t b;
+  size_t k;
+  size_t t;
+  size_t r;
+
+  if (!pl || !iv || !bs || !bd || !pl->on)
+    return (0);
+  STAT_BEGIN(ns);
+  for (b = 0; b * bs < ln; ++b)
+    *(bd + b) = 0;
+  /* the syndromes of as many bytes as fit a tile at a time */
+  for (k = 0; k < ln; k += t) {
+    t = TILE_SIZE / pl->on;
+    if (t > bs - k % bs)
+      t = bs - k % bs;
+    if (t > ln - k)
+      t = ln - k;
+    for (j = 0; j < pl->in; ++j)
+      vv[j] = *(iv + j) + k;
+    for (i = 0; i < pl->on; ++i)
+      sv[i] = sb + i * t;
+    apply(pl, vv, sv, 0, t);
+    b = k / bs;
+    for (r = 0; r < t && *(bd + b) != ~0U; ++r) {
+      for (i = 0; i < pl->on && !*(sb + i * t + r); ++i);
+      if (i == pl->on)
+        continue;
+      if ((j = locate(pl, sb + r, t)) != ~0U)
+        ++j;
+      if (!*(bd + b))
+        *(bd + b) = j;
+      else if (*(bd + b) != j)
+        *(bd + b) = ~0U;
+    }
+  }
+  for (nb = 0, b = 0; b * bs < ln; ++b)
+    nb += *(bd + b) != 0;
+  STAT_APPLY(pl->bk, ns, ln);
+  return (nb);
+}
+
+/* Berlekamp-Welch: with y the values of a polynomial P of degree below tn
+ * at the n points x, but for at most e = (n - tn) / 2 of them, there is
+ * E of degree e (0 at those points, the leading coefficient 1) and Q of
+ * degree below tn + e with Q(xi) = yi * E(xi) for all i, and P is Q / E.
+ * Q and E are found solving the n equations for their tn + 2e unknown
+ * coefficients, any solution when there are fewer errors.  Returns 0 and
+ * the coefficients of P in p, or -1 if more than e are wrong. */
+static int
+welch(
+  const unsigned char *x
+ ,const unsigned char *y
+ ,unsigned int n
+ ,unsigned int tn
+ ,unsigned char *p
+){
+  unsigned char m[256][256 + 1];
+  unsigned char s[256];
+  unsigned char q[256];
+  unsigned int e;
+  unsigned int u;
+  unsigned int r;
+  unsigned int c;
+  unsigned int i;
+  unsigned int k;
+  unsigned char v;
+  unsigned char w;
+
+  e = (n - tn) / 2;
+  u = tn + 2 * e;
+  /* q0 ... q(tn + e - 1), e0 ... e(e - 1) and yi * xi^e */
+  for (i = 0; i < n; ++i) {
+    for (v = 1, k = 0; k < tn + e; ++k, v = CMUL(v, *(x + i)))
+      m[i][k] = v;
+    for (v = 1, k = 0; k < e; ++k, v = CMUL(v, *(x + i)))
+      m[i][tn + e + k] = CMUL(*(y + i), v);
+    for (v = 1, k = 0; k < e; ++k)
+      v = CMUL(v, *(x + i));
+    m[i][u] = CMUL(*(y + i), v);
+  }
+  /* Gauss-Jordan, with the free unknowns 0 */
+  for (k = 0; k < u; ++k)
+    s[k] = 0;
+  for (r = 0, c = 0; c < u && r < n; ++c) {
+    for (i = r; i < n && !m[i][c]; ++i);
+    if (i == n)
+      continue;
+    for (k = c; k <= u; ++k)
+      v = m[i][k], m[i][k] = m[r][k], m[r][k] = v;
+    w = CINV(m[r][c]);
+    for (k = c; k <= u; ++k)
+      m[r][k] = CMUL(m[r][k], w);
+    for (i = 0; i < n; ++i)
+      if (i != r && (v = m[i][c]))
+        for (k = c; k <= u; ++k)
+          m[i][k] ^= CMUL(v, m[r][k]);
+    q[r++] = c;
+  }
+  for (i = r; i < n; ++i)
+    if (m[i][u])
+      return (-1);
+  for (i = 0; i < r; ++i)
+    s[q[i]] = m[i][u];
+  /* P = Q / E, E is s[tn + e] ... s[tn + 2e - 1] and 1 */
+  for (k = tn + e; k-- > e;) {
+    v = *(p + k - e) = s[k];
+    for (i = 0; i < e; ++i)
+      s[k - e + i] ^= CMUL(v, s[tn + e + i]);
+  }
+  for (k = 0; k < e; ++k)
+    if (s[k])
+      return (-1);
+  /* and P is right at all but at most e points */
+  for (r = 0, i = 0; i < n; ++i) {
+    for (v = 0, k = tn; k--;)
+      v = CMUL(v, *(x + i)) ^ *(p + k);
+    r += v != *(y + i);
+  }
+  return (r > e ? -1 : 0);
+}
+
+size_t
+sssDecode(
+  struct sssDecode *dc
+ ,unsigned char **iv
+ ,unsigned char **ov
+ ,size_t ln
+){
+  unsigned char sb[TILE_SIZE];
+  unsigned char *vv[256];
+  unsigned char *ww[256];
+  unsigned char y[256];
+  unsigned char p[256];
+  unsigned long long ns;
+  struct sssPlan *pl;
+  unsigned int sn;
+  unsigned int i;
+  unsigned int j;
+  unsigned char v;
+  size_t ue;
+  size_t k;
+  size_t t;
+  size_t r;
+
+  if (!dc || !iv || !ov)
+    return (0);
+  STAT_BEGIN(ns);
+  pl = &dc->pl;
+  sn = pl->on - dc->on;
+  /* the outputs as if all is well, and the syndromes, a tile at a time */
+  for (ue = 0, k = 0; k < ln; k += t) {
+    t = sn && ln - k > TILE_SIZE / sn ? TILE_SIZE / sn : ln - k;
+    for (j = 0; j < pl->in; ++j)
+      vv[j] = *(iv + j) + k;
+    for (i = 0; i < dc->on; ++i)
+      ww[i] = *(ov + i) + k;
+    for (i = 0; i < sn; ++i)
+      ww[dc->on + i] = sb + i * t;
+    apply(pl, vv, ww, 0, t);
+    /* only where not is each byte decoded */
+    for (r = 0; r < t; ++r) {
+      /* skipping 8 bytes at a time where all is well */
+      if (!(r & 7) && r + 8 <= t) {
+        unsigned long long x;
+        unsigned long long z;
+
+        for (z = 0, i = 0; i < sn; ++i) {
+          memcpy(&x, sb + i * t + r, 8);
+          z |= x;
+        }
+        if (!z) {
+          r += 7;
+          continue;
+        }
+      }
+      for (i = 0; i < sn && !*(sb + i * t + r); ++i);
+      if (i == sn)
+        continue;
+      for (j = 0; j < pl->in; ++j)
+        y[j] = *(vv[j] + r);
+      if (welch(dc->ip, y, pl->in, dc->tn, p)) {
+        ++ue;
+        continue;
+      }
+      for (i = 0; i < dc->on; ++i) {
+        for (v = 0, j = dc->tn; j--;)
+          v = CMUL(v, dc->op[i]) ^ p[j];
+        *(ww[i] + r) = v;
+      }
+    }
+  }
+  STAT_APPLY(pl->bk, ns, ln);
+  return (ue);
+}
+
+/* ChaCha20 keystream for generated input j, from byte p of the value */
+/*   the 64 bit block counter is state words 12 and 13, j is word 14 */
+
+#define ROTL(x, n) (((x) << (n) | (x) >> (32 - (n))) & 0xffffffff)
+#define QR(a, b, c, d) ( \
+  a = (a + b) & 0xffffffff, d ^= a, d = ROTL(d, 16), \
+  c = (c + d) & 0xffffffff, b ^= c, b = ROTL(b, 12), \
+  a = (a + b) & 0xffffffff, d ^= a, d = ROTL(d, 8), \
+  c = (c + d) & 0xffffffff, b ^= c, b = ROTL(b, 7))
+
+static void
+stream(
+  const unsigned char *ky
+ ,unsigned int j
+ ,unsigned long long p
+ ,unsigned char *b
+ ,size_t ln
+){
+  unsigned long s[16];
+  unsigned long x[16];
+  unsigned long long n;
+  unsigned int i;
+  unsigned int w;
+  size_t k;
+
+  s[0] = 0x61707865;
+  s[1] = 0x3320646e;
+  s[2] = 0x79622d32;
+  s[3] = 0x6b206574;
+  for (w = 0; w < 8; ++w)
+    s[4 + w] = (unsigned long)*(ky + 4 * w)
+             | (unsigned long)*(ky + 4 * w + 1) << 8
+             | (unsigned long)*(ky + 4 * w + 2) << 16
+             | (unsigned long)*(ky + 4 * w + 3) << 24;
+  s[14] = j;
+  s[15] = 0;
+  for (n = p / 64, i = p % 64, k = 0; k < ln; ++n, i = 0) {
+    s[12] = n & 0xffffffff;
+    s[13] = n >> 32 & 0xffffffff;
+    for (w = 0; w < 16; ++w)
+      x[w] = s[w];
+    for (w = 0; w < 10; ++w) {
+      QR(x[0], x[4], x[8], x[12]);
+      QR(x[1], x[5], x[9], x[13]);
+      QR(x[2], x[6], x[10], x[14]);
+      QR(x[3], x[7], x[11], x[15]);
+      QR(x[0], x[5], x[10], x[15]);
+      QR(x[1], x[6], x[11], x[12]);
+      QR(x[2], x[7], x[8], x[13]);
+      QR(x[3], x[4], x[9], x[14]);
+    }
+    for (; i < 64 && k < ln; ++i, ++k)
+      *(b + k) = (x[i / 4] + s[i / 4]) >> (i % 4 * 8);
+  }
+}
+
+#undef QR
+#undef ROTL
+
+void
+sssSplit(
+  struct sssPlan *pl
+ ,const unsigned char *ky
+ ,unsigned char **iv
+ ,unsigned char **ov
+ ,unsigned int vn
+ ,unsigned long long of
+ ,size_t ln
+){
+  unsigned char rb[TILE_SIZE];
+  unsigned long long ns;
+  const unsigned char *v;
+  mac_t mac;
+  unsigned int i;
+  unsigned int j;
+  size_t k;
+  size_t t;
+
+  if (!pl || !ky || (vn && !iv) || !ov || vn > pl->in)
+    return;
+  STAT_BEGIN(ns);
+  mac = Mac[pl->bk];
+  /* outputs that are given inputs are a copy, or nothing if given the input buffer */
+  for (i = 0; i < pl->on; ++i)
+    if (pl->pt[i] && pl->pt[i] <= vn && *(ov + i) != *(iv + pl->pt[i] - 1))
+      memcpy(*(ov + i), *(iv + pl->pt[i] - 1), ln);
+    else if (!pl->pt[i] && !pl->in)
+      memset(*(ov + i), 0, ln);
+  /* each input a tile at a time, so a generated input is never more than a tile */
+  for (k = 0; k < ln; k += t) {
+    t = ln - k < TILE_SIZE ? ln - k : TILE_SIZE;
+    for (j = 0; j < pl->in; ++j) {
+      if (j < vn)
+        v = *(iv + j) + k;
+      else {
+        stream(ky, j, of + k, rb, t);
+        v = rb;
+      }
+      for (i = 0; i < pl->on; ++i)
+        if (!pl->pt[i])
+          mac(*(ov + i) + k, 0, v, 0, pl->cf[i][j], t, 1, j);
+        else if (pl->pt[i] - 1 == j && j >= vn)
+          memcpy(*(ov + i) + k, v, t);
+    }
+  }
+  STAT_APPLY(pl->bk, ns, ln);
+}
+
+struct chunk {
+  struct sssPlan *pl;
+  unsigned char **iv;
+  unsigned char **ov;
+  size_t ln;
+  size_t cs; /* chunk size */
+};
+
+static void
+chunk(
+  void *ar
+ ,unsigned int ck
+){
+  unsigned long long ns;
+  struct chunk *c;
+  size_t of;
+  size_t ln;
+
+  c = ar;
+  if ((of = (size_t)ck * c->cs) >= c->ln)
+    return;
+  STAT_BEGIN(ns);
+  ln = c->ln - of < c->cs ? c->ln - of : c->cs;
+  apply(c->pl, c->iv, c->ov, of, ln);
+  STAT_APPLY(c->pl->bk, ns, ln);
+}
+
+void
+sssParallel(
+  struct sssPlan *pl
+ ,unsigned char **iv
+ ,unsigned char **ov
+ ,size_t ln
+ ,unsigned int cn
+ ,void (*ex)(void *, void (*)(void *, unsigned int), void *, unsigned int)
+ ,void *cx
+){
+  struct chunk c;
+  unsigned int i;
+
+  if (!pl || !iv || !ov)
+    return;
+  if (!cn)
+    cn = 1;
+  c.pl = pl;
+  c.iv = iv;
+  c.ov = ov;
+  c.ln = ln;
+  /* cache line multiples so no two chunks write the same line */
+  c.cs = ((ln / cn + (ln % cn != 0)) + 63) & ~(size_t)63;
+  STAT_CHUNKS(cn);
+  if (ex)
+    ex(cx, chunk, &c, cn);
+  else
+    for (i = 0; i < cn; ++i)
+      chunk(&c, i);
+}
+
+struct multi {
+  struct sssPlan *pl;
+  struct sssSet *st;
+  size_t sn;
+  size_t cs; /* chunk size, of all the sets' bytes end to end */
+};
+
+static void
+multi(
+  void *ar
+ ,unsigned int ck
+){
+  unsigned long long ns;
+  struct multi *m;
+  size_t of;
+  size_t ln;
+  size_t s;
+  size_t t;
+
+  m = ar;
+  of = (size_t)ck * m->cs;
+  ln = m->cs;
+  STAT_BEGIN(ns);
+  /* find the set where the chunk starts and do it until the chunk is done */
+  for (s = 0; s < m->sn && of >= (m->st + s)->ln; ++s)
+    of -= (m->st + s)->ln;
+  for (; s < m->sn && ln; ++s, of = 0) {
+    t = (m->st + s)->ln - of < ln ? (m->st + s)->ln - of : ln;
+    apply(m->pl, (m->st + s)->iv, (m->st + s)->ov, of, t);
+    ln -= t;
+  }
+  STAT_APPLY(m->pl->bk, ns, m->cs - ln);
+}
+
+void
+sssMulti(
+  struct sssPlan *pl
+ ,struct sssSet *st
+ ,size_t sn
+ ,unsigned int cn
+ ,void (*ex)(void *, void (*)(void *, unsigned int), void *, unsigned int)
+ ,void *cx
+){
+  struct multi m;
+  unsigned int i;
+  size_t ln;
+  size_t s;
+
+  if (!pl || !st)
+    return;
+  if (!cn)
+    cn = 1;
+  for (ln = 0, s = 0; s < sn; ++s)
+    ln += (st + s)->ln;
+  m.pl = pl;
+  m.st = st;
+  m.sn = sn;
+  m.cs = ((ln / cn + (ln % cn != 0)) + 63) & ~(size_t)63;
+  if (!m.cs)
+    return;
+  STAT_CHUNKS(cn);
+  if (ex)
+    ex(cx, multi, &m, cn);
+  else
+    for (i = 0; i < cn; ++i)
+      multi(&m, i);
+}
+
+void
+sssBatch(
+  struct sssPlan *pl
+ ,unsigned char *iv
+ ,unsigned char *ov
+ ,size_t ln
+ ,size_t cn
+){
+  unsigned char *ib[256];
+  unsigned char *ob[256];
+  unsigned long long ns;
+  fix_t fix;
+  mac_t mac;
+  size_t is;
+  size_t os;
+  size_t sb;
+  size_t s;
+  size_t n;
+  size_t r;
+  unsigned int i;
+  unsigned int j;
+
+  if (!pl || !iv || !ov || !ln)
+    return;
+  STAT_BEGIN(ns);
+  is = pl->in * ln;
+  os = pl->on * ln;
+  /* long values are done a set at a time */
+  if (ln >= TILE_SIZE) {
+    for (s = 0; s < cn; ++s) {
+      for (j = 0; j < pl->in; ++j)
+        ib[j] = iv + s * is + j * ln;
+      for (i = 0; i < pl->on; ++i)
+        ob[i] = ov + s * os + i * ln;
+      apply(pl, ib, ob, 0, ln);
+    }
+    STAT_APPLY(pl->bk, ns, cn * ln);
+    return;
+  }
+  /* short values are done as many sets at a time as fit a tile */
+  fix = fixed(pl);
+  mac = Mac[pl->bk];
+  sb = TILE_SIZE / ln;
+  for (s = 0; s < cn; s += n) {
+    n = cn - s < sb ? cn - s : sb;
+    if (fix) {
+      for (j = 0; j < pl->in; ++j)
+        ib[j] = iv + s * is + j * ln;
+      for (i = 0; i < pl->on; ++i)
+        ob[i] = ov + s * os + i * ln;
+      fix(pl->cf, ib, ob, 0, ln, is, os, n, 0);
+      continue;
+    }
+    for (i = 0; i < pl->on; ++i)
+      if (pl->pt[i])
+        for (r = 0; r < n; ++r)
+          memcpy(ov + (s + r) * os + i * ln, iv + (s + r) * is + (pl->pt[i] - 1) * ln, ln);
+      else if (!pl->in)
+        for (r = 0; r < n; ++r)
+          memset(ov + (s + r) * os + i * ln, 0, ln);
+      else
+        for (j = 0; j < pl->in; ++j)
+          mac(ov + s * os + i * ln, os, iv + s * is + j * ln, is, pl->cf[i][j], ln, n, j);
+  }
+  STAT_APPLY(pl->bk, ns, cn * ln);
+}
+
+void
+sssRecover0(
+  unsigned char *ip
+ ,unsigned char **iv
+ ,unsigned char *ov
+ ,unsigned int in
+ ,size_t ln
+){
+  unsigned char cf[256];
+  unsigned char ic[256];
+  unsigned char oc;
+  unsigned char z;
+  unsigned long long ns;
+  unsigned int bk;
+  unsigned int i;
+  unsigned int j;
+
+  if (!ip || !iv || !ov || in > 256)
+    return;
+  for (i = 0; i < in; ++i)
+    for (j = i + 1; j < in; ++j)
+      if (*(ip + i) == *(ip + j))
+        return;
+  INIT();
+  STAT_BEGIN(ns);
+  /* as sss with the one output point 0, without a plan */
+  for (bk = SSS_NEON; !supported(bk); --bk);
+  z = 0;
+  crosses(ip, &z, in, 1, ic, &oc);
+  if (!in)
+    memset(ov, 0, ln);
+  else if (!oc) {
+    for (j = 0; *(ip + j); ++j);
+    if (ov != *(iv + j)) {
+      memcpy(ov, *(iv + j), ln);
+      STAT_COPY(ln);
+    }
+  } else {
+    row(cf, ip, ic, in, 0, oc);
+    if (in > 1 && One[bk])
+      oneRow(One[bk], cf, iv, ov, in, 0, ln);
+    else
+      for (j = 0; j < in; ++j)
+        if (!j || cf[j]) /* nothing to add */
+          Mac[bk](ov, 0, *(iv + j), 0, cf[j], ln, 1, j);
+    STAT_APPLY(bk, ns, ln);
+  }
+}
+
+void
+sss(
+  unsigned char *ip
+ ,unsigned char *op
+ ,unsigned char **iv
+ ,unsigned char **ov
+ ,unsigned int in
+ ,unsigned int on
+ ,unsigned int ln
+){
+  unsigned char cf[FIX_ON][256]; /* coefficient rows, all only for a fixed layout */
+  unsigned char ic[256];
+  unsigned char oc[256];
+  unsigned long long ns;
+  unsigned int bk;
+  unsigned int rn;
+  unsigned int i;
+  unsigned int j;
+  mac_t mac;
+  size_t k;
+  size_t t;
+
+  if (!ip || !op || !iv || !ov || in > 256 || on > 256)
+    return;
+  for (i = 0; i < in; ++i)
+    for (j = i + 1; j < in; ++j)
+      if (*(ip + i) == *(ip + j))
+        return;
+  INIT();
+  STAT_BEGIN(ns);
+  /* as sssPlan and sssApply, but a row of coefficients at a time */
+  for (bk = SSS_NEON; !supported(bk); --bk);
+  crosses(ip, op, in, on, ic, oc);
+  /* outputs that are inputs are a copy, or nothing if given the input buffer */
+  for (rn = 0, i = 0; i < on; ++i)
+    if (!in)
+      memset(*(ov + i), 0, ln);
+    else if (oc[i])
+      ++rn;
+    else {
+      for (j = 0; *(op + i) != *(ip + j); ++j);
+      if (*(ov + i) != *(iv + j)) {
+        memcpy(*(ov + i), *(iv + j), ln);
+        STAT_COPY(ln);
+      }
+    }
+  if (!in || !rn)
+    return;
+  if (rn == on && (bk == SSS_AVX2 || bk == SSS_AVX512))
+    for (k = 0; k < sizeof (Fix) / sizeof (Fix[0]); ++k)
+      if (Fix[k].fn && Fix[k].in == in && Fix[k].on == on) {
+        for (i = 0; i < on; ++i)
+          row(cf[i], ip, ic, in, *(op + i), oc[i]);
+        Fix[k].fn(cf, iv, ov, 0, ln, 0, 0, 1, streamed(ov, in, on, ln));
+        STAT_APPLY(bk, ns, ln);
+        return;
+      }
+  if (rn == 1 && in > 1 && One[bk]) {
+    for (i = 0; !oc[i]; ++i);
+    row(cf[0], ip, ic, in, *(op + i), oc[i]);
+    oneRow(One[bk], cf[0], iv, *(ov + i), in, 0, ln);
+    STAT_APPLY(bk, ns, ln);
+    return;
+  }
+  mac = Mac[bk];
+  /* a tile at a time so the output tile stays in cache across the inputs, */
+  /*   a row is a few multiplies for each input next to a tile of them */
+  for (k = 0; k < ln; k += t) {
+    t = ln - k < TILE_SIZE ? ln - k : TILE_SIZE;
+    for (i = 0; i < on; ++i)
+      if (oc[i]) {
+        row(cf[0], ip, ic, in, *(op + i), oc[i]);
+        for (j = 0; j < in; ++j)
+          if (!j || cf[0][j]) /* nothing to add */
+            mac(*(ov + i) + k, 0, *(iv + j) + k, 0, cf[0][j], t, 1, j);
+      }
+  }
+  STAT_APPLY(bk, ns, ln);
+}
+
+int
+sssStats(
+  struct sssStats *st
+ ,int rs
+){
+#if SSS_STATS
+  unsigned int k;
+
+  if (st) {
+    st->pn = STAT_GET(pn);
+    st->pt = STAT_GET(pt);
+    st->kn = STAT_GET(kn);
+    st->kt = STAT_GET(kt);
+    st->kb = STAT_GET(kb);
+    st->cb = STAT_GET(cb);
+    for (k = 0; k < sizeof (st->bb) / sizeof (st->bb[0]); ++k)
+      st->bb[k] = STAT_GET(bb[k]);
+    st->bk = STAT_GET(bk);
+    st->cn = STAT_GET(cn);
+  }
+  if (rs) {
+    STAT_SET(pn, 0);
+    STAT_SET(pt, 0);
+    STAT_SET(kn, 0);
+    STAT_SET(kt, 0);
+    STAT_SET(kb, 0);
+    STAT_SET(cb, 0);
+    for (k = 0; k < sizeof (Stats.bb) / sizeof (Stats.bb[0]); ++k)
+      STAT_SET(bb[k], 0);
+    STAT_SET(bk, 0);
+    STAT_SET(cn, 0);
+  }
+  return (0);
+#else
+  (void)st;
+  (void)rs;
+  return (-1);
+#endif
+}
@@ -18,6 +18,32 @@
  * along with this program.  If not, see <https://www.gnu.org/licenses/>.
  */
 
+#include <stddef.h>
+
+/* when built without generated tables (CON_TABLES 0) sssInit fills them */
+/*   which the first plan does if it has not been called (once, with other */
+/*   threads waiting for it), so calling it first only moves that time; */
+/*   otherwise sssInit does nothing */
+/* built with a compiler other than gcc or clang, without their atomics, */
+/*   sssInit must be called before starting threads and any other call */
+void
+sssInit(
+  void
+);
+
+/* the product of a and b and the inverse of a (0 for 0) in the field of */
+/*   the values, for fields built on it such as that of sss16 */
+unsigned char
+sssMul(
+  unsigned char a
+ ,unsigned char b
+);
+
+unsigned char
+sssInv(
+  unsigned char a
+);
+
 /* all buffers of values are the same length */
 /* to create N values with a M value threshold of some reference value */
 /*   input point 0 is the reference value */
@@ -36,3 +62,267 @@ sss(
  ,unsigned int on /* number of op and ov */
  ,unsigned int ln /* length of each value buffer */
 );
+
+/* the same computation split in two, with lengths beyond unsigned int: */
+/*   sssPlan does the point crosses once for a set of input and output points */
+/*   sssApply does the value buffers and may be called any number of times */
+/* each byte is independent of the others and a plan keeps no state between calls */
+/*   so buffers too large for memory can be given to sssApply a chunk at a time */
+/*   and a range of bytes of the values is sssApply with each buffer advanced to it */
+
+/* output buffers must not overlap input buffers, except that an output */
+/*   whose point is an input point may be given that input's buffer, */
+/*   and is then left as it is */
+
+/* backends, all produce identical output */
+#define SSS_AUTO   (~0U) /* best supported */
+#define SSS_SCALAR 0 /* table lookup */
+#define SSS_SSSE3  1 /* x86 16 byte nibble shuffle */
+#define SSS_AVX2   2 /* x86 32 byte nibble shuffle */
+#define SSS_AVX512 3 /* x86 64 byte nibble shuffle */
+#define SSS_NEON   4 /* aarch64 16 byte nibble table */
+#define SSS_CT     5 /* constant time 8 byte bit slices, no tables */
+/* the scalar backend looks up the values in a table, so their cache footprint */
+/*   can be seen by others sharing the machine: SSS_CT is portable and does not, */
+/*   nor do the vector backends (the table shuffle is in registers) */
+/* on x86 when the buffers of a call come to more than 32MB, outputs that */
+/*   are stored once (by the one output and fixed layout kernels) are */
+/*   stored past the cache, with the inputs prefetched, as they are not */
+/*   expected to be read again soon */
+
+/* precomputed coefficients for a set of points */
+struct sssPlan {
+  unsigned char cf[256][256]; /* coefficient of input j for output i */
+  unsigned int pt[256]; /* if not 0, output i is input (pt[i] - 1) */
+  unsigned int in; /* number of input points */
+  unsigned int on; /* number of output points */
+  unsigned int bk; /* backend, sssPlan picks SSS_AUTO */
+  unsigned int fx; /* if not 0, fixed layout kernel (fx - 1) for in and on */
+};
+
+/* returns 0 on success, -1 on bad arguments (including duplicate input points) */
+int
+sssPlan(
+  struct sssPlan *pl /* plan to fill */
+ ,unsigned char *ip /* input points */
+ ,unsigned char *op /* output points */
+ ,unsigned int in /* number of ip */
+ ,unsigned int on /* number of op */
+);
+
+/* a plan whose inputs are the coefficients of the polynomial, lowest first */
+/*   instead of its values at input points, so shares are evaluated directly */
+/*   coefficient 0 is the secret and the others are random, e.g. from sssSplit */
+/*   (an output point 0 is the secret itself) */
+/* returns 0 on success, -1 on bad arguments */
+int
+sssPlanPoly(
+  struct sssPlan *pl /* plan to fill */
+ ,unsigned char *op /* output points */
+ ,unsigned int in /* number of coefficients (the threshold) */
+ ,unsigned int on /* number of op */
+);
+
+/* a plan from in values at points ip to the in coefficients of their */
+/*   polynomial, lowest first, as sssPlanPoly takes them: so the coefficients */
+/*   can be kept instead of the shares and new shares made from them */
+/*   (new shares can also be made directly from shares, as many in one pass */
+/*   as there are output points, with a plan from sssPlan) */
+/* returns 0 on success, -1 on bad arguments (including duplicate input points) */
+int
+sssPlanCoef(
+  struct sssPlan *pl /* plan to fill */
+ ,unsigned char *ip /* input points */
+ ,unsigned int in /* number of ip, and of coefficients */
+);
+
+/* a plan from in shares of one set to on shares of a new set with threshold tn */
+/*   without recovering the secret: the inputs are the in shares followed by */
+/*   tn - 1 random values, e.g. sssSplit with vn in, fresh for each reshare */
+/*   the new set can be the old points (refreshing the shares) or others */
+/* returns 0 on success, -1 on bad arguments (including output point 0, */
+/*   and tn below 2, as each new share would then be the secret) */
+int
+sssPlanReshare(
+  struct sssPlan *pl /* plan to fill */
+ ,unsigned char *ip /* input points of the old shares */
+ ,unsigned char *op /* output points of the new shares */
+ ,unsigned int in /* number of ip (the old threshold) */
+ ,unsigned int tn /* new threshold, at least 2, in + tn - 1 at most 256 */
+ ,unsigned int on /* number of op */
+);
+
+/* a plan to check that in shares with threshold tn are of one value: */
+/*   the outputs are in - tn syndromes, all 0 when the shares are consistent */
+/* returns 0 on success, -1 on bad arguments (including tn not below in) */
+int
+sssPlanCheck(
+  struct sssPlan *pl /* plan to fill */
+ ,unsigned char *ip /* points of the shares */
+ ,unsigned int in /* number of ip */
+ ,unsigned int tn /* threshold */
+);
+
+void
+sssApply(
+  struct sssPlan *pl /* plan from sssPlan */
+ ,unsigned char **iv /* input value buffers */
+ ,unsigned char **ov /* output value buffers */
+ ,size_t ln /* length of each value buffer */
+);
+
+/* check shares in one pass with a plan from sssPlanCheck, a block at a time: */
+/*   bd[b] is for bytes b * bs to (b + 1) * bs, 0 if the shares are consistent, */
+/*   k + 1 if share k being wrong explains it (which takes in - tn of at least 2) */
+/*   or ~0 if no one share does */
+/* returns the number of blocks that are not consistent */
+size_t
+sssCheck(
+  struct sssPlan *pl /* plan from sssPlanCheck */
+ ,unsigned char **iv /* share value buffers */
+ ,size_t ln /* length of each value buffer */
+ ,size_t bs /* block size */
+ ,unsigned int *bd /* (ln + bs - 1) / bs blocks */
+);
+
+/* recovery from more shares than the threshold that corrects wrong ones */
+struct sssDecode {
+  struct sssPlan pl; /* the outputs then the syndromes, as sssPlanCheck */
+  unsigned char ip[256]; /* input points */
+  unsigned char op[256]; /* output points */
+  unsigned int tn; /* threshold */
+  unsigned int on; /* number of output points */
+};
+
+/* in shares with threshold tn of which up to (in - tn) / 2 may be wrong */
+/* returns 0 on success, -1 on bad arguments (on is at most 256 - (in - tn)) */
+int
+sssPlanDecode(
+  struct sssDecode *dc /* decode to fill */
+ ,unsigned char *ip /* input points */
+ ,unsigned char *op /* output points */
+ ,unsigned int in /* number of ip */
+ ,unsigned int tn /* threshold */
+ ,unsigned int on /* number of op */
+);
+
+/* sssApply with the shares checked, only the bytes where they are not */
+/*   consistent are decoded (Berlekamp-Welch) from all of them */
+/* returns the number of bytes that could not be, with too many wrong shares */
+/*   whose outputs are from the first tn shares */
+size_t
+sssDecode(
+  struct sssDecode *dc /* decode from sssPlanDecode */
+ ,unsigned char **iv /* input value buffers */
+ ,unsigned char **ov /* output value buffers */
+ ,size_t ln /* length of each value buffer */
+);
+
+/* returns 0 on success, -1 if the backend is not supported on this CPU */
+int
+sssBackend(
+  struct sssPlan *pl /* plan from sssPlan */
+ ,unsigned int bk /* SSS_AUTO or one of the above */
+);
+
+/* sssApply with the buffers split into cn chunks that can be done concurrently */
+/*   the executor ex must call fn(ar, 0) to fn(ar, cn - 1) on any threads */
+/*   in any order and return when all have returned */
+/*   without an executor the chunks are done by the caller */
+void
+sssParallel(
+  struct sssPlan *pl /* plan from sssPlan */
+ ,unsigned char **iv /* input value buffers */
+ ,unsigned char **ov /* output value buffers */
+ ,size_t ln /* length of each value buffer */
+ ,unsigned int cn /* number of chunks */
+ ,void (*ex)(void *cx, void (*fn)(void *ar, unsigned int ck), void *ar, unsigned int cn) /* executor or 0 */
+ ,void *cx /* executor context */
+);
+
+/* a set of values, for sssMulti */
+struct sssSet {
+  unsigned char **iv; /* input value buffers */
+  unsigned char **ov; /* output value buffers */
+  size_t ln; /* length of each value buffer */
+};
+
+/* sssParallel for sn independent sets of values with the same points */
+/*   all the sets' bytes are split into cn chunks, so a chunk can be */
+/*   many short sets or part of a long one */
+/*   (short sets laid out as sssBatch wants are faster with sssBatch) */
+void
+sssMulti(
+  struct sssPlan *pl /* plan from sssPlan */
+ ,struct sssSet *st /* sets of values */
+ ,size_t sn /* number of st */
+ ,unsigned int cn /* number of chunks */
+ ,void (*ex)(void *cx, void (*fn)(void *ar, unsigned int ck), void *ar, unsigned int cn) /* executor or 0 */
+ ,void *cx /* executor context */
+);
+
+/* sssApply for cn sets of values with contiguous buffers */
+/*   iv is cn sets of in buffers and ov is cn sets of on buffers, each of ln bytes */
+void
+sssBatch(
+  struct sssPlan *pl /* plan from sssPlan */
+ ,unsigned char *iv /* cn * in * ln bytes of input values */
+ ,unsigned char *ov /* cn * on * ln bytes of output values */
+ ,size_t ln /* length of each value */
+ ,size_t cn /* number of sets */
+);
+
+/* sssApply generating all but the first vn inputs, to split a secret */
+/*   without supplying the random values: e.g. a plan with input points */
+/*   0 (the secret) to M - 1 and vn 1 */
+/* generated input j is the ChaCha20 keystream of the key with nonce j */
+/*   so the same key must never be used for two secrets */
+/* of is where these ln bytes start in the whole value, so a value can be */
+/*   done in chunks (or concurrent parts) and get the same result */
+void
+sssSplit(
+  struct sssPlan *pl /* plan from sssPlan */
+ ,const unsigned char *ky /* 32 byte key from a cryptographically secure source */
+ ,unsigned char **iv /* the first vn input value buffers */
+ ,unsigned char **ov /* output value buffers */
+ ,unsigned int vn /* number of iv, inputs vn to in - 1 are generated */
+ ,unsigned long long of /* offset of these bytes in the value */
+ ,size_t ln /* length of each value buffer */
+);
+
+/* sss recovering the reference value (output point 0) from in values */
+/*   that is the usual recovery, and any plan of one output with no */
+/*   input at its point is done by the vector backends in one pass over */
+/*   the inputs, a group of them at a time, storing each output vector once */
+void
+sssRecover0(
+  unsigned char *ip /* input points */
+ ,unsigned char **iv /* input value buffers */
+ ,unsigned char *ov /* output value buffer */
+ ,unsigned int in /* number of ip and iv */
+ ,size_t ln /* length of each value buffer */
+);
+
+/* counters of the work done, kept when built with SSS_STATS 1 (default 0) */
+/*   times are nanoseconds of CLOCK_MONOTONIC, kernel time is summed over */
+/*   the threads doing chunks, so can be more than the time elapsed */
+struct sssStats {
+  unsigned long long pn; /* plans made */
+  unsigned long long pt; /* time making plans */
+  unsigned long long kn; /* calls or chunks applied */
+  unsigned long long kt; /* time applying */
+  unsigned long long kb; /* bytes of each value applied */
+  unsigned long long cb; /* bytes of outputs copied from inputs */
+  unsigned long long bb[6]; /* bytes of kb by backend */
+  unsigned int bk; /* backend of the last apply */
+  unsigned int cn; /* chunks of the last sssParallel or sssMulti */
+};
+
+/* copies the counters to st (if not 0) then, if rs, zeroes them */
+/*   while other threads apply, each counter is read on its own */
+/* returns 0 on success, -1 if built without SSS_STATS */
+int
+sssStats(
+  struct sssStats *st /* counters or 0 */
+ ,int rs /* zero the counters */
+);
@@ -0,0 +1,336 @@
+/*
+ * ShamirSecretSharing - A C language implementation of Shamir's secret sharing algorithm
+ * Copyright (C) 2015-2023 G. David Butler <gdb@dbSystems.com>
+ *
+ * This file is part of ShamirSecretSharing
+ *
+ * ShamirSecretSharing is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ShamirSecretSharing is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/* The nimbers below 2^16 are a field with those below F = 2^8 a subfield
+ * and F * F = F + F/2, so with a = a1 F + a0 and b = b1 F + b0:
+ *   a * b = (a1 b1 + a1 b0 + a0 b1) F + a0 b0 + (F/2) a1 b1
+ * where a1 b0 + a0 b1 = (a1 + a0)(b1 + b0) + a1 b1 + a0 b0, three
+ * products in the subfield and one by F/2.  The other root of
+ * X^2 + X + F/2 is F + 1, so the conjugate of a is a1 F + a0 + a1 and
+ * a times it is the subfield element a0 a0 + a0 a1 + (F/2) a1 a1:
+ * the inverse of a is the conjugate over that.
+ *
+ * Multiply by a constant c is linear, so it is the xor of c times each
+ * byte (split tables of 256 symbols) or each nibble (16 entry shuffles
+ * of the low and high bytes of the products) of the symbol. */
+
+#include <string.h>
+#include "sss.h"
+#include "sss16.h"
+
+#ifndef SIMD_KERNELS
+#define SIMD_KERNELS 1 /* use vector instructions when available */
+#endif
+#ifndef TILE16_SIZE
+#define TILE16_SIZE 4096 /* symbols of each buffer done at a time */
+#endif
+
+#if SIMD_KERNELS && defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define SIMD_X86 1
+#include <immintrin.h>
+#else
+#define SIMD_X86 0
+#endif
+
+void
+sss16Init(
+  void
+){
+  sssInit();
+}
+
+/* the subfield products are those of sss */
+static unsigned short
+mul16(
+  unsigned short a
+ ,unsigned short b
+){
+  unsigned char p;
+  unsigned char q;
+
+  p = sssMul(a >> 8, b >> 8);
+  q = sssMul(a & 0xff, b & 0xff);
+  return ((sssMul((a >> 8) ^ (a & 0xff), (b >> 8) ^ (b & 0xff)) ^ q) << 8
+   | (q ^ sssMul(128, p)));
+}
+
+static unsigned short
+inv16(
+  unsigned short a
+){
+  unsigned char a1;
+  unsigned char a0;
+
+  a1 = a >> 8;
+  a0 = a & 0xff;
+  return (mul16(a ^ a1, sssInv(sssMul(a0, a0) ^ sssMul(a0, a1) ^ sssMul(128, sssMul(a1, a1)))));
+}
+
+int
+sss16Plan(
+  struct sss16Plan *pl
+ ,unsigned short *cf
+ ,const unsigned short *ip
+ ,const unsigned short *op
+ ,unsigned int in
+ ,unsigned int on
+){
+  unsigned short *ic;
+  unsigned short *r;
+  unsigned short n;
+  unsigned int i;
+  unsigned int j;
+  unsigned int k;
+
+  if (!pl || (in && on && !cf) || !ip || !op || in > 65536)
+    return (-1);
+  for (i = 0; i < in; ++i)
+    for (j = i + 1; j < in; ++j)
+      if (*(ip + i) == *(ip + j))
+        return (-1);
+  pl->cf = cf;
+  pl->in = in;
+  pl->on = on;
+  sss16Backend(pl, SSS_AUTO);
+  if (!in || !on)
+    return (0);
+  /* inverse in crosses (xi-xj) kept in the last row, which is done last in place */
+  ic = cf + (size_t)(on - 1) * in;
+  for (j = 0; j < in; ++j) {
+    for (n = 1, k = 0; k < in; ++k)
+      if (k != j)
+        n = mul16(n, *(ip + j) ^ *(ip + k));
+    *(ic + j) = inv16(n);
+  }
+  for (i = 0; i < on; ++i) {
+    r = cf + (size_t)i * in;
+    for (n = 1, j = 0; j < in; ++j)
+      n = mul16(n, *(op + i) ^ *(ip + j));
+    if (!n) /* an input */
+      for (j = 0; j < in; ++j)
+        *(r + j) = *(op + i) == *(ip + j);
+    else
+      for (j = 0; j < in; ++j)
+        *(r + j) = mul16(n, mul16(*(ic + j), inv16(*(op + i) ^ *(ip + j))));
+  }
+  return (0);
+}
+
+/* Each kernel does o = (a ? o : 0) ^ c * v over ln symbols */
+
+/* c times each bit of a symbol, the rest by linearity */
+static void
+bits(
+  unsigned short c
+ ,unsigned short *b
+){
+  unsigned int k;
+
+  for (k = 0; k < 16; ++k)
+    *(b + k) = mul16(c, 1U << k);
+}
+
+static void
+macScalar(
+  unsigned short *o
+ ,const unsigned short *v
+ ,unsigned short c
+ ,size_t ln
+ ,int a
+){
+  unsigned short lo[256];
+  unsigned short hi[256];
+  unsigned short b[16];
+  unsigned int k;
+  size_t i;
+
+  bits(c, b);
+  lo[0] = hi[0] = 0;
+  for (k = 1; k < 256; ++k)
+    if (!(k & (k - 1))) {
+      for (i = 0; k >> i != 1; ++i);
+      lo[k] = b[i];
+      hi[k] = b[i + 8];
+    } else {
+      lo[k] = lo[k & (k - 1)] ^ lo[k & -k];
+      hi[k] = hi[k & (k - 1)] ^ hi[k & -k];
+    }
+  if (a)
+    for (i = 0; i < ln; ++i)
+      *(o + i) ^= lo[*(v + i) & 0xff] ^ hi[*(v + i) >> 8];
+  else
+    for (i = 0; i < ln; ++i)
+      *(o + i) = lo[*(v + i) & 0xff] ^ hi[*(v + i) >> 8];
+}
+
+#if SIMD_X86
+
+/* The products of nibble p of a symbol are split into low (l) and high (h)
+ * byte tables.  The low byte of a symbol holds nibbles 0 and 1 and the
+ * high byte 2 and 3, so the shuffle indexes have bit 7 set in the other
+ * byte (a shuffle gives 0 there) and the products for the other byte are
+ * moved over by a shift of the 16 bit lane. */
+
+__attribute__((target("avx2")))
+static void
+macAvx2(
+  unsigned short *o
+ ,const unsigned short *v
+ ,unsigned short c
+ ,size_t ln
+ ,int a
+){
+  unsigned char t[4][2][16];
+  unsigned short b[16];
+  __m256i tl[4];
+  __m256i th[4];
+  __m256i mk;
+  __m256i me;
+  __m256i mo;
+  __m256i x;
+  __m256i l;
+  __m256i h;
+  __m256i s;
+  __m256i u;
+  __m256i d;
+  unsigned short y;
+  unsigned int p;
+  unsigned int k;
+  unsigned int i;
+  size_t n;
+
+  bits(c, b);
+  for (p = 0; p < 4; ++p) {
+    for (k = 0; k < 16; ++k) {
+      for (y = 0, i = 0; i < 4; ++i)
+        if (k >> i & 1)
+          y ^= b[4 * p + i];
+      t[p][0][k] = y & 0xff;
+      t[p][1][k] = y >> 8;
+    }
+    tl[p] = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i *)t[p][0]));
+    th[p] = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i *)t[p][1]));
+  }
+  mk = _mm256_set1_epi8(0x0f);
+  me = _mm256_set1_epi16((short)0x8000); /* the low bytes only */
+  mo = _mm256_set1_epi16(0x0080); /* the high bytes only */
+  for (n = 0; n + 16 <= ln; n += 16) {
+    x = _mm256_loadu_si256((const __m256i *)(v + n));
+    l = _mm256_and_si256(x, mk);
+    h = _mm256_and_si256(_mm256_srli_epi16(x, 4), mk);
+    /* products staying in their byte */
+    s = _mm256_xor_si256(
+        _mm256_xor_si256(_mm256_shuffle_epi8(tl[0], _mm256_or_si256(l, me))
+                        ,_mm256_shuffle_epi8(tl[1], _mm256_or_si256(h, me)))
+       ,_mm256_xor_si256(_mm256_shuffle_epi8(th[2], _mm256_or_si256(l, mo))
+                        ,_mm256_shuffle_epi8(th[3], _mm256_or_si256(h, mo))));
+    /* and moving up or down a byte */
+    u = _mm256_xor_si256(_mm256_shuffle_epi8(th[0], _mm256_or_si256(l, me))
+                        ,_mm256_shuffle_epi8(th[1], _mm256_or_si256(h, me)));
+    d = _mm256_xor_si256(_mm256_shuffle_epi8(tl[2], _mm256_or_si256(l, mo))
+                        ,_mm256_shuffle_epi8(tl[3], _mm256_or_si256(h, mo)));
+    x = _mm256_xor_si256(s, _mm256_xor_si256(_mm256_slli_epi16(u, 8), _mm256_srli_epi16(d, 8)));
+    if (a)
+      x = _mm256_xor_si256(x, _mm256_loadu_si256((const __m256i *)(o + n)));
+    _mm256_storeu_si256((__m256i *)(o + n), x);
+  }
+  /* the short end from the same tables */
+  for (; n < ln; ++n) {
+    for (y = 0, p = 0; p < 4; ++p) {
+      k = *(v + n) >> 4 * p & 15;
+      y ^= t[p][0][k] | t[p][1][k] << 8;
+    }
+    *(o + n) = a ? *(o + n) ^ y : y;
+  }
+}
+
+#endif /* SIMD_X86 */
+
+typedef void (*mac_t)(unsigned short *, const unsigned short *, unsigned short, size_t, int);
+
+/* indexed by backend, 0 when not compiled in */
+static const mac_t Mac[] = {
+  macScalar
+ ,0
+#if SIMD_X86
+ ,macAvx2
+#else
+ ,0
+#endif
+};
+
+static int
+supported(
+  unsigned int bk
+){
+  if (bk >= sizeof (Mac) / sizeof (Mac[0]) || !Mac[bk])
+    return (0);
+#if SIMD_X86
+  if (bk == SSS_AVX2)
+    return (__builtin_cpu_supports("avx2"));
+#endif
+  return (1);
+}
+
+int
+sss16Backend(
+  struct sss16Plan *pl
+ ,unsigned int bk
+){
+  if (!pl)
+    return (-1);
+  if (bk == SSS_AUTO) {
+    for (bk = sizeof (Mac) / sizeof (Mac[0]) - 1; !supported(bk); --bk);
+  } else if (!supported(bk))
+    return (-1);
+  pl->bk = bk;
+  return (0);
+}
+
+void
+sss16Apply(
+  struct sss16Plan *pl
+ ,unsigned short **iv
+ ,unsigned short **ov
+ ,size_t ln
+){
+  mac_t mac;
+  unsigned int i;
+  unsigned int j;
+  size_t k;
+  size_t t;
+
+  if (!pl || !iv || !ov)
+    return;
+  if (!pl->in) {
+    for (i = 0; i < pl->on; ++i)
+      memset(*(ov + i), 0, ln * sizeof (**ov));
+    return;
+  }
+  mac = Mac[pl->bk];
+  /* TILE16_SIZE symbols of every output at a time, as apply in sss.c does bytes */
+  for (k = 0; k < ln; k += t) {
+    t = ln - k < TILE16_SIZE ? ln - k : TILE16_SIZE;
+    for (i = 0; i < pl->on; ++i)
+      for (j = 0; j < pl->in; ++j)
+        if (!j || *(pl->cf + (size_t)i * pl->in + j))
+          mac(*(ov + i) + k, *(iv + j) + k, *(pl->cf + (size_t)i * pl->in + j), t, j);
+  }
+}
@@ -0,0 +1,73 @@
+/*
+ * ShamirSecretSharing - A C language implementation of Shamir's secret sharing algorithm
+ * Copyright (C) 2015-2023 G. David Butler <gdb@dbSystems.com>
+ *
+ * This file is part of ShamirSecretSharing
+ *
+ * ShamirSecretSharing is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ShamirSecretSharing is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <stddef.h>
+
+/* sss over the 65536 nimbers below 2^16 instead of the 256 below 2^8, */
+/*   so there can be up to 65535 shares: the values are 16 bit symbols */
+/*   and the points 0 to 65535 */
+/* points below 256 multiply as in sss, so those values of it are the same */
+/*   for values of symbols below 256 */
+
+/* sss16 multiplies with sss's tables, so sss16Init is sssInit: when sss.c */
+/*   is built without generated tables the first plan fills them if it has */
+/*   not been called, as sss.h says */
+void
+sss16Init(
+  void
+);
+
+/* backends are SSS_AUTO, SSS_SCALAR (split 256 entry tables) and SSS_AVX2 */
+/*   (nibble shuffles) from sss.h, all produce identical output */
+
+/* precomputed coefficients for a set of points, in storage from the caller */
+struct sss16Plan {
+  unsigned short *cf; /* in * on: coefficient of input j for output i at i * in + j */
+  unsigned int in; /* number of input points */
+  unsigned int on; /* number of output points */
+  unsigned int bk; /* backend, sss16Plan picks SSS_AUTO */
+};
+
+/* returns 0 on success, -1 on bad arguments (including duplicate input points) */
+int
+sss16Plan(
+  struct sss16Plan *pl /* plan to fill */
+ ,unsigned short *cf /* in * on coefficients */
+ ,const unsigned short *ip /* input points */
+ ,const unsigned short *op /* output points */
+ ,unsigned int in /* number of ip, up to 65536 */
+ ,unsigned int on /* number of op */
+);
+
+/* output buffers must not overlap input buffers */
+void
+sss16Apply(
+  struct sss16Plan *pl /* plan from sss16Plan */
+ ,unsigned short **iv /* input value buffers */
+ ,unsigned short **ov /* output value buffers */
+ ,size_t ln /* symbols of each value buffer */
+);
+
+/* returns 0 on success, -1 if the backend is not supported on this CPU */
+int
+sss16Backend(
+  struct sss16Plan *pl /* plan from sss16Plan */
+ ,unsigned int bk /* SSS_AUTO, SSS_SCALAR or SSS_AVX2 */
+);
@@ -0,0 +1,423 @@
+/*
+ * ShamirSecretSharing - A C language implementation of Shamir's secret sharing algorithm
+ * Copyright (C) 2015-2023 G. David Butler <gdb@dbSystems.com>
+ *
+ * This file is part of ShamirSecretSharing
+ *
+ * ShamirSecretSharing is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ShamirSecretSharing is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/* Benchmark of the library entry points.
+ *
+ * Usage: sssbench [-m M,...] [-n N,...] [-l LN,...] [-t threads] [-s seconds]
+ *   M is the number of inputs (2 to 255), N the number of outputs (1 to 255)
+ *   and LN the length of each value (suffix k, m or g for powers of 1024).
+ *   By default LN goes past the last level cache, to 64m.
+ *   Configurations whose buffers need more than half the physical memory
+ *   are skipped, with a line starting # saying so. With threads, sssParallel
+ *   and sssMulti run on a pool started once, as in main.
+ *
+ * One tab separated line is printed per entry point, backend and configuration:
+ *   function backend M N LN threads iterations seconds MB/s ns/byte
+ * where MB/s and ns/byte are per byte of value length (LN). */
+
+#define _POSIX_C_SOURCE 200112L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include "sss.h"
+#include "sss16.h"
+
+static const char *Bn[] = { "scalar", "ssse3", "avx2", "avx512", "neon", "ct" };
+
+static void
+error(
+  const char *errmsg
+){
+  fprintf(stderr, "%s\n", errmsg);
+  exit(EXIT_FAILURE);
+}
+
+static double
+now(
+  void
+){
+  struct timespec t;
+
+  clock_gettime(CLOCK_MONOTONIC, &t);
+  return (t.tv_sec + t.tv_nsec / 1e9);
+}
+
+/* bytes of buffers a configuration may use, half the physical memory or 2GB */
+static double
+limit(
+  void
+){
+  long p;
+  long s;
+
+  p = sysconf(_SC_PHYS_PAGES);
+  s = sysconf(_SC_PAGESIZE);
+  if (p <= 0 || s <= 0)
+    return (2.0 * (1 << 30));
+  return ((double)p * s / 2);
+}
+
+/* a pool of threads, started once, executing the chunks of sssParallel */
+/*   and sssMulti with the caller, as the one of main does */
+struct pool {
+  pthread_mutex_t mx;
+  pthread_cond_t wk; /* work posted */
+  pthread_cond_t dn; /* work done */
+  void (*fn)(void *, unsigned int);
+  void *ar;
+  unsigned int cn; /* number of chunks */
+  unsigned int nx; /* next chunk */
+  unsigned int bz; /* chunks in progress */
+};
+
+static void
+run(
+  struct pool *p
+){
+  unsigned int ck;
+
+  while (p->nx < p->cn) {
+    ck = p->nx++;
+    ++p->bz;
+    pthread_mutex_unlock(&p->mx);
+    p->fn(p->ar, ck);
+    pthread_mutex_lock(&p->mx);
+    if (!--p->bz && p->nx >= p->cn)
+      pthread_cond_signal(&p->dn);
+  }
+}
+
+static void *
+worker(
+  void *v
+){
+  struct pool *p;
+
+  p = v;
+  pthread_mutex_lock(&p->mx);
+  for (;;) {
+    while (p->nx >= p->cn)
+      pthread_cond_wait(&p->wk, &p->mx);
+    run(p);
+  }
+  return (0);
+}
+
+static void
+execute(
+  void *cx
+ ,void (*fn)(void *, unsigned int)
+ ,void *ar
+ ,unsigned int cn
+){
+  struct pool *p;
+
+  p = cx;
+  pthread_mutex_lock(&p->mx);
+  p->fn = fn;
+  p->ar = ar;
+  p->cn = cn;
+  p->nx = 0;
+  pthread_cond_broadcast(&p->wk);
+  run(p);
+  while (p->bz || p->nx < p->cn)
+    pthread_cond_wait(&p->dn, &p->mx);
+  pthread_mutex_unlock(&p->mx);
+}
+
+/* the caller is a thread too */
+static void
+poolInit(
+  struct pool *p
+ ,unsigned int th
+){
+  pthread_t t;
+  unsigned int k;
+
+  pthread_mutex_init(&p->mx, 0);
+  pthread_cond_init(&p->wk, 0);
+  pthread_cond_init(&p->dn, 0);
+  p->cn = p->nx = p->bz = 0;
+  for (k = 1; k < th; ++k)
+    if (pthread_create(&t, 0, worker, p))
+      error("pthread_create.");
+}
+
+static unsigned int
+list(
+  const char *s
+ ,size_t *v
+ ,unsigned int n
+){
+  unsigned int i;
+  char *e;
+
+  for (i = 0; i < n && *s; ++i) {
+    v[i] = strtoul(s, &e, 10);
+    switch (*e) {
+    case 'g': case 'G':
+      v[i] <<= 10;
+      /* FALLTHROUGH */
+    case 'm': case 'M':
+      v[i] <<= 10;
+      /* FALLTHROUGH */
+    case 'k': case 'K':
+      v[i] <<= 10;
+      ++e;
+    }
+    if (e == s || (*e && *e != ','))
+      error("Bad list.");
+    s = *e ? e + 1 : e;
+  }
+  return (i);
+}
+
+static void
+report(
+  const char *fn
+ ,const char *bk
+ ,unsigned int m
+ ,unsigned int n
+ ,size_t ln
+ ,unsigned int th
+ ,unsigned long it
+ ,double s
+){
+  printf("%s\t%s\t%u\t%u\t%lu\t%u\t%lu\t%.6f\t%.1f\t%.3f\n", fn, bk, m, n, (unsigned long)ln, th, it, s
+   ,(double)ln * it / s / 1e6, s * 1e9 / ((double)ln * it));
+}
+
+int
+main(
+  int argc
+ ,char *argv[]
+){
+  static struct sssPlan pl;
+  static struct pool pool;
+  size_t mv[64] = { 2, 3, 5, 16, 255 };
+  size_t nv[64] = { 1, 2, 5, 9, 64, 255 };
+  size_t lv[64] = { 16, 4096, 1 << 20, 64 << 20 };
+  unsigned int mn = 5;
+  unsigned int nn = 6;
+  unsigned int ln = 4;
+  unsigned int th;
+  unsigned int a;
+  unsigned int b;
+  unsigned int c;
+  double mt;
+  double mb;
+
+  sssInit();
+  sss16Init();
+  th = 1;
+  mt = 0.2;
+  for (a = 1; a < (unsigned int)argc; ++a) {
+    if (a + 1 == (unsigned int)argc || argv[a][0] != '-' || !argv[a][1] || argv[a][2])
+      error("Usage: sssbench [-m M,...] [-n N,...] [-l LN,...] [-t threads] [-s seconds]");
+    switch (argv[a++][1]) {
+    case 'm':
+      mn = list(argv[a], mv, 64);
+      break;
+    case 'n':
+      nn = list(argv[a], nv, 64);
+      break;
+    case 'l':
+      ln = list(argv[a], lv, 64);
+      break;
+    case 't':
+      if (!(th = atoi(argv[a])) || th > 256)
+        error("Bad thread count.");
+      break;
+    case 's':
+      if ((mt = atof(argv[a])) <= 0)
+        error("Bad seconds.");
+      break;
+    default:
+      error("Unknown option.");
+    }
+  }
+  if (th > 1)
+    poolInit(&pool, th);
+  mb = limit();
+  printf("#function\tbackend\tM\tN\tLN\tthreads\titerations\tseconds\tMB/s\tns/byte\n");
+  for (a = 0; a < mn; ++a)
+   for (b = 0; b < nn; ++b)
+    for (c = 0; c < ln; ++c) {
+      unsigned char ip[256];
+      unsigned char op[256];
+      unsigned char *iv[256];
+      unsigned char *ov[256];
+      struct sssSet *st;
+      unsigned char **sv;
+      unsigned char *bi;
+      unsigned char *bo;
+      unsigned long it;
+      unsigned int m;
+      unsigned int n;
+      unsigned int i;
+      unsigned int k;
+      size_t l;
+      size_t j;
+      size_t r;
+      double s;
+
+      m = mv[a];
+      n = nv[b];
+      l = lv[c];
+      if (m < 2 || m > 255 || n < 1 || n > 255 || !l)
+        error("Bad configuration.");
+      if ((m + n) * (double)l > mb) {
+        printf("#skipped\t-\t%u\t%u\t%lu\tbuffers over %.0fMB\n", m, n, (unsigned long)l, mb / (1 << 20));
+        continue;
+      }
+      /* inputs 0 to M - 1, outputs cycle through the others */
+      for (i = 0; i < m; ++i)
+        ip[i] = i;
+      for (i = 0; i < n; ++i)
+        op[i] = m + i % (256 - m);
+      if (!(bi = malloc(m * l)) || !(bo = malloc(n * l)))
+        error("malloc.");
+      for (j = 0; j < m * l; ++j)
+        bi[j] = rand();
+      for (i = 0; i < m; ++i)
+        iv[i] = bi + i * l;
+      for (i = 0; i < n; ++i)
+        ov[i] = bo + i * l;
+      if (sssPlan(&pl, ip, op, m, n))
+        error("sssPlan.");
+
+      if (l <= ~0U) {
+        it = 0;
+        s = now();
+        do {
+          sss(ip, op, iv, ov, m, n, l);
+          ++it;
+        } while (now() - s < mt);
+        report("sss", Bn[pl.bk], m, n, l, 1, it, now() - s);
+      }
+
+      it = 0;
+      s = now();
+      do {
+        sssPlan(&pl, ip, op, m, n);
+        ++it;
+      } while (now() - s < mt);
+      /* per byte numbers are not meaningful for the plan, report it as one byte */
+      report("sssPlan", "-", m, n, 1, 1, it, now() - s);
+
+      for (k = 0; k < sizeof (Bn) / sizeof (Bn[0]); ++k) {
+        if (sssBackend(&pl, k))
+          continue;
+        it = 0;
+        s = now();
+        do {
+          sssApply(&pl, iv, ov, l);
+          ++it;
+        } while (now() - s < mt);
+        report("sssApply", Bn[k], m, n, l, 1, it, now() - s);
+
+        if (th > 1) {
+          it = 0;
+          s = now();
+          do {
+            sssParallel(&pl, iv, ov, l, th, execute, &pool);
+            ++it;
+          } while (now() - s < mt);
+          report("sssParallel", Bn[k], m, n, l, th, it, now() - s);
+        }
+      }
+      sssBackend(&pl, SSS_AUTO);
+
+      /* the same buffers as LN / 2 symbols of the 16 bit field */
+      if (!(l % 2)) {
+        struct sss16Plan pw;
+        unsigned short wi[256];
+        unsigned short wo[256];
+        unsigned short *cw;
+
+        for (i = 0; i < m; ++i)
+          wi[i] = ip[i];
+        for (i = 0; i < n; ++i)
+          wo[i] = op[i];
+        if (!(cw = malloc(m * n * sizeof (*cw))) || sss16Plan(&pw, cw, wi, wo, m, n))
+          error("sss16Plan.");
+        /* scalar and avx2 */
+        for (k = SSS_SCALAR; k <= SSS_AVX2; k += SSS_AVX2) {
+          if (sss16Backend(&pw, k))
+            continue;
+          it = 0;
+          s = now();
+          do {
+            sss16Apply(&pw, (unsigned short **)iv, (unsigned short **)ov, l / 2);
+            ++it;
+          } while (now() - s < mt);
+          report("sss16Apply", Bn[k], m, n, l, 1, it, now() - s);
+        }
+        free(cw);
+      }
+      free(bi);
+      free(bo);
+
+      /* as many sets as make a MB */
+      if (l < 1 << 20) {
+        j = (1 << 20) / l;
+        if (!(bi = malloc(j * m * l)) || !(bo = malloc(j * n * l)))
+          error("malloc.");
+        memset(bi, 0x5a, j * m * l);
+        it = 0;
+        s = now();
+        do {
+          sssBatch(&pl, bi, bo, l, j);
+          it += j;
+        } while (now() - s < mt);
+        report("sssBatch", Bn[pl.bk], m, n, l, 1, it, now() - s);
+
+        /* the same sets through sssMulti */
+        if (!(st = malloc(j * sizeof (*st))) || !(sv = malloc(j * (m + n) * sizeof (*sv))))
+          error("malloc.");
+        for (r = 0; r < j; ++r) {
+          (st + r)->iv = sv + r * (m + n);
+          (st + r)->ov = sv + r * (m + n) + m;
+          (st + r)->ln = l;
+          for (i = 0; i < m; ++i)
+            *((st + r)->iv + i) = bi + (r * m + i) * l;
+          for (i = 0; i < n; ++i)
+            *((st + r)->ov + i) = bo + (r * n + i) * l;
+        }
+        it = 0;
+        s = now();
+        do {
+          sssMulti(&pl, st, j, th, th > 1 ? execute : 0, &pool);
+          it += j;
+        } while (now() - s < mt);
+        report("sssMulti", Bn[pl.bk], m, n, l, th, it, now() - s);
+        free(st);
+        free(sv);
+        free(bi);
+        free(bo);
+      }
+      fflush(stdout);
+    }
+  return (0);
+}
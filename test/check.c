@@ -0,0 +1,779 @@
+/*
+ * ShamirSecretSharing - A C language implementation of Shamir's secret sharing algorithm
+ * Copyright (C) 2015-2023 G. David Butler <gdb@dbSystems.com>
+ *
+ * This file is part of ShamirSecretSharing
+ *
+ * ShamirSecretSharing is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ShamirSecretSharing is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/* Checks of the library entry points against sss.
+ *
+ * Usage: ssscheck
+ *   Each supported backend is compared with sss for layouts that reach the
+ *   fixed, one output and general kernels, lengths either side of each
+ *   vector width and buffers at unaligned addresses.
+ *   sssBatch and sssMulti are checked against sss a set at a time.
+ *   sssCheck passes consistent shares and finds and locates wrong ones,
+ *   the last byte included.
+ *   sssDecode corrects up to its bound of wrong shares, wherever they are,
+ *   fails past it and without wrong shares gives what sss does.
+ *   sss16 is checked against sss for 8 bit points and values, a split into
+ *   1000 shares is recovered from some of them and its backends are compared.
+ *   A line is printed per failure, the exit status is 1 if any. */
+
+#define _POSIX_C_SOURCE 200112L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "sss.h"
+#include "sss16.h"
+
+static const char *Bn[] = { "scalar", "ssse3", "avx2", "avx512", "neon", "ct" };
+
+/* input and output counts: fixed layouts, one output either side of a group, general */
+static const unsigned int Sh[][2] = {
+  {2, 3}, {3, 5}, {5, 9}, {1, 1}, {2, 1}, {16, 1}, {17, 1}, {40, 1}, {4, 7}, {9, 2}, {255, 1}
+};
+
+/* either side of 16, 32, 64 and 128 and over a tile */
+static const size_t Ln[] = {
+  0, 1, 15, 16, 17, 31, 32, 33, 63, 64, 65, 127, 128, 129, 255, 256, 1000, 8192 + 129
+};
+
+/* buffer offsets from 64 byte alignment */
+static const size_t Al[] = { 0, 1, 7, 33 };
+
+/* the same for sss16, in symbols: either side of 8, 16 and 32 */
+static const unsigned int Sh16[][2] = {
+  {1, 1}, {2, 3}, {5, 9}, {16, 1}, {40, 3}, {300, 2}
+};
+static const size_t Ln16[] = { 0, 1, 7, 8, 9, 15, 16, 17, 31, 32, 33, 63, 64, 65, 1000 };
+static const size_t Al16[] = { 0, 1, 3 };
+
+#define GUARD 0xa5 /* byte after each output buffer, must be left as it is */
+
+static unsigned int Fails;
+
+static void
+error(
+  const char *errmsg
+){
+  fprintf(stderr, "%s\n", errmsg);
+  exit(EXIT_FAILURE);
+}
+
+static void
+fail(
+  const char *fn
+ ,const char *bk
+ ,unsigned int in
+ ,unsigned int on
+ ,size_t ln
+ ,size_t al /* offset of the buffers, or number of sets, set or threshold */
+){
+  printf("FAIL\t%s\t%s\t%u\t%u\t%lu\t%lu\n", fn, bk, in, on, (unsigned long)ln, (unsigned long)al);
+  ++Fails;
+}
+
+static void
+fill(
+  unsigned char *b
+ ,size_t ln
+){
+  size_t k;
+
+  for (k = 0; k < ln; ++k)
+    *(b + k) = rand();
+}
+
+/* in distinct input points, on output points some of which are input points */
+static void
+points(
+  unsigned char *ip
+ ,unsigned char *op
+ ,unsigned int in
+ ,unsigned int on
+){
+  unsigned char p[256];
+  unsigned int i;
+  unsigned int j;
+  unsigned char t;
+
+  for (i = 0; i < 256; ++i)
+    p[i] = i;
+  for (i = 255; i; --i) {
+    j = rand() % (i + 1);
+    t = p[i];
+    p[i] = p[j];
+    p[j] = t;
+  }
+  memcpy(ip, p, in);
+  for (i = 0; i < on; ++i)
+    *(op + i) = in && !(rand() % 4) ? *(ip + rand() % in) : p[(in + i) % 256];
+}
+
+/* each backend's sssApply against sss */
+static void
+backends(
+  void
+){
+  static struct sssPlan pl;
+  unsigned char ip[256];
+  unsigned char op[256];
+  unsigned char *ib[256];
+  unsigned char *ob[256];
+  unsigned char *rb[256];
+  unsigned char *iv[256];
+  unsigned char *ov[256];
+  unsigned char *rv[256];
+  unsigned int s;
+  unsigned int l;
+  unsigned int a;
+  unsigned int bk;
+  unsigned int i;
+  unsigned int in;
+  unsigned int on;
+  size_t ln;
+
+  for (s = 0; s < sizeof (Sh) / sizeof (Sh[0]); ++s) {
+    in = Sh[s][0];
+    on = Sh[s][1];
+    for (l = 0; l < sizeof (Ln) / sizeof (Ln[0]); ++l) {
+      ln = Ln[l];
+      for (i = 0; i < in; ++i)
+        if (posix_memalign((void **)(ib + i), 64, ln + 128))
+          error("posix_memalign.");
+      for (i = 0; i < on; ++i)
+        if (posix_memalign((void **)(ob + i), 64, ln + 128)
+         || posix_memalign((void **)(rb + i), 64, ln + 128))
+          error("posix_memalign.");
+      for (a = 0; a < sizeof (Al) / sizeof (Al[0]); ++a) {
+        points(ip, op, in, on);
+        for (i = 0; i < in; ++i) {
+          iv[i] = ib[i] + Al[a];
+          fill(iv[i], ln);
+        }
+        for (i = 0; i < on; ++i) {
+          ov[i] = ob[i] + Al[(a + i) % (sizeof (Al) / sizeof (Al[0]))];
+          rv[i] = rb[i] + Al[a];
+        }
+        sss(ip, op, iv, rv, in, on, ln);
+        if (sssPlan(&pl, ip, op, in, on))
+          error("sssPlan.");
+        for (bk = SSS_SCALAR; bk <= SSS_CT; ++bk) {
+          if (sssBackend(&pl, bk))
+            continue;
+          for (i = 0; i < on; ++i)
+            memset(ov[i], GUARD, ln + 1);
+          sssApply(&pl, iv, ov, ln);
+          for (i = 0; i < on; ++i)
+            if (memcmp(ov[i], rv[i], ln) || ov[i][ln] != GUARD)
+              break;
+          if (i < on)
+            fail("sssApply", Bn[bk], in, on, ln, Al[a]);
+        }
+        /* the usual recovery, of point 0 (a copy if it is an input) */
+        if (in) {
+          op[0] = 0;
+          sss(ip, op, iv, rv, in, 1, ln);
+          memset(ov[0], GUARD, ln + 1);
+          sssRecover0(ip, iv, ov[0], in, ln);
+          if (memcmp(ov[0], rv[0], ln) || ov[0][ln] != GUARD)
+            fail("sssRecover0", "auto", in, 1, ln, Al[a]);
+        }
+      }
+      for (i = 0; i < in; ++i)
+        free(ib[i]);
+      for (i = 0; i < on; ++i) {
+        free(ob[i]);
+        free(rb[i]);
+      }
+    }
+  }
+}
+
+/* sssBatch against sss for each set */
+static void
+batch(
+  void
+){
+  static struct sssPlan pl;
+  unsigned char ip[256];
+  unsigned char op[256];
+  unsigned char *iv[256];
+  unsigned char *ov[256];
+  unsigned char *ib;
+  unsigned char *ob;
+  unsigned char *rb;
+  unsigned int s;
+  unsigned int l;
+  unsigned int bk;
+  unsigned int i;
+  unsigned int in;
+  unsigned int on;
+  size_t c;
+  size_t cn;
+  size_t ln;
+
+  for (s = 0; s < sizeof (Sh) / sizeof (Sh[0]); ++s)
+    for (l = 0; l < sizeof (Ln) / sizeof (Ln[0]) && Ln[l] <= 1000; ++l) {
+      in = Sh[s][0];
+      on = Sh[s][1];
+      ln = Ln[l];
+      cn = 1 + rand() % 37;
+      if (!(ib = malloc(cn * in * ln + 1))
+       || !(ob = malloc(cn * on * ln + 1))
+       || !(rb = malloc(cn * on * ln + 1)))
+        error("malloc.");
+      fill(ib, cn * in * ln);
+      points(ip, op, in, on);
+      for (c = 0; c < cn; ++c) {
+        for (i = 0; i < in; ++i)
+          iv[i] = ib + (c * in + i) * ln;
+        for (i = 0; i < on; ++i)
+          ov[i] = rb + (c * on + i) * ln;
+        sss(ip, op, iv, ov, in, on, ln);
+      }
+      if (sssPlan(&pl, ip, op, in, on))
+        error("sssPlan.");
+      for (bk = SSS_SCALAR; bk <= SSS_CT; ++bk) {
+        if (sssBackend(&pl, bk))
+          continue;
+        memset(ob, GUARD, cn * on * ln + 1);
+        sssBatch(&pl, ib, ob, ln, cn);
+        if (memcmp(ob, rb, cn * on * ln) || ob[cn * on * ln] != GUARD)
+          fail("sssBatch", Bn[bk], in, on, ln, cn);
+      }
+      free(ib);
+      free(ob);
+      free(rb);
+    }
+}
+
+/* an executor for sssMulti doing the chunks last first, as any order is allowed */
+static void
+backward(
+  void *cx
+ ,void (*fn)(void *, unsigned int)
+ ,void *ar
+ ,unsigned int cn
+){
+  (void)cx;
+  while (cn)
+    fn(ar, --cn);
+}
+
+/* sssMulti against sss for each set, of lengths from 0 to over a tile */
+static void
+multi(
+  void
+){
+  static struct sssPlan pl;
+  static const unsigned int Cn[] = { 1, 3, 16 };
+  struct sssSet st[20];
+  unsigned char ip[256];
+  unsigned char op[256];
+  unsigned char **rv;
+  unsigned int s;
+  unsigned int c;
+  unsigned int i;
+  unsigned int in;
+  unsigned int on;
+  size_t n;
+  size_t sn;
+
+  for (s = 0; s < sizeof (Sh) / sizeof (Sh[0]); ++s)
+    for (c = 0; c < 2 * sizeof (Cn) / sizeof (Cn[0]); ++c) {
+      in = Sh[s][0];
+      on = Sh[s][1];
+      sn = 1 + rand() % 20;
+      if (!(rv = malloc(sn * on * sizeof (*rv))))
+        error("malloc.");
+      points(ip, op, in, on);
+      for (n = 0; n < sn; ++n) {
+        st[n].ln = Ln[rand() % (sizeof (Ln) / sizeof (Ln[0]))];
+        if (!(st[n].iv = malloc(in * sizeof (*st[n].iv)))
+         || !(st[n].ov = malloc(on * sizeof (*st[n].ov))))
+          error("malloc.");
+        for (i = 0; i < in; ++i) {
+          if (!(st[n].iv[i] = malloc(st[n].ln)))
+            error("malloc.");
+          fill(st[n].iv[i], st[n].ln);
+        }
+        for (i = 0; i < on; ++i) {
+          if (!(st[n].ov[i] = malloc(st[n].ln + 1))
+           || !(rv[n * on + i] = malloc(st[n].ln)))
+            error("malloc.");
+          memset(st[n].ov[i], GUARD, st[n].ln + 1);
+        }
+        sss(ip, op, st[n].iv, rv + n * on, in, on, st[n].ln);
+      }
+      if (sssPlan(&pl, ip, op, in, on))
+        error("sssPlan.");
+      sssMulti(&pl, st, sn, Cn[c / 2], c % 2 ? backward : 0, 0);
+      for (n = 0; n < sn; ++n) {
+        for (i = 0; i < on; ++i)
+          if (memcmp(st[n].ov[i], rv[n * on + i], st[n].ln) || st[n].ov[i][st[n].ln] != GUARD)
+            break;
+        if (i < on)
+          fail("sssMulti", "auto", in, on, st[n].ln, n);
+        for (i = 0; i < in; ++i)
+          free(st[n].iv[i]);
+        for (i = 0; i < on; ++i) {
+          free(st[n].ov[i]);
+          free(rv[n * on + i]);
+        }
+        free(st[n].iv);
+        free(st[n].ov);
+      }
+      free(rv);
+    }
+}
+
+/* sssCheck of in shares with threshold tn on each backend, with share */
+/*   wb (or none if in) wrong at byte r and the last byte, and if w2 share */
+/*   w2 - 1 wrong at r too: the blocks of those have to be reported */
+static void
+checkCase(
+  unsigned int tn
+ ,unsigned int in
+ ,unsigned int wb
+ ,unsigned int w2
+ ,size_t r
+){
+  static struct sssPlan pl;
+  unsigned int bd[(1000 + 63) / 64];
+  unsigned char ip[256];
+  unsigned char *cv[256];
+  unsigned char *iv[256];
+  unsigned int e;
+  unsigned int x;
+  unsigned int bk;
+  unsigned int i;
+  size_t b;
+  size_t bn;
+  size_t ln;
+
+  ln = 1000;
+  bn = (ln + 63) / 64;
+  points(ip, ip, in, 0);
+  for (i = 0; i < tn; ++i) {
+    if (!(cv[i] = malloc(ln)))
+      error("malloc.");
+    fill(cv[i], ln);
+  }
+  for (i = 0; i < in; ++i)
+    if (!(iv[i] = malloc(ln)))
+      error("malloc.");
+  if (sssPlanPoly(&pl, ip, tn, in))
+    error("sssPlanPoly.");
+  sssApply(&pl, cv, iv, ln);
+  if (wb < in) {
+    *(iv[wb] + r) ^= 1 + rand() % 255;
+    *(iv[wb] + ln - 1) ^= 1 + rand() % 255;
+  }
+  if (w2)
+    *(iv[w2 - 1] + r) ^= 1 + rand() % 255;
+  /* what the wrong block at r gives, one share located only with two checks */
+  x = w2 ? ~0U : in - tn < 2 ? ~0U : wb + 1;
+  if (sssPlanCheck(&pl, ip, in, tn))
+    error("sssPlanCheck.");
+  for (bk = SSS_SCALAR; bk <= SSS_CT; ++bk) {
+    if (sssBackend(&pl, bk))
+      continue;
+    e = sssCheck(&pl, iv, ln, 64, bd);
+    for (b = 0; b < bn; ++b)
+      if (wb < in && b == r / 64 ? bd[b] != x
+       : wb < in && b == bn - 1 ? bd[b] != (in - tn < 2 ? ~0U : wb + 1)
+       : bd[b] != 0)
+        break;
+    if (b < bn || e != (wb < in ? 2U : 0U))
+      fail("sssCheck", Bn[bk], in, tn, ln, wb);
+  }
+  for (i = 0; i < tn; ++i)
+    free(cv[i]);
+  for (i = 0; i < in; ++i)
+    free(iv[i]);
+}
+
+/* sssCheck of consistent shares and of each one wrong */
+static void
+check(
+  void
+){
+  unsigned int i;
+
+  checkCase(3, 7, 7, 0, 0);
+  checkCase(2, 3, 3, 0, 0);
+  for (i = 0; i < 7; ++i)
+    checkCase(3, 7, i, 0, rand() % (1000 - 64));
+  checkCase(3, 4, 1, 0, 100);
+  checkCase(3, 7, 2, 6, 500);
+}
+
+/* shares at ip of a polynomial of tn random coefficients, the bn shares */
+/*   bd wrong (in all bytes if dn, else in about half and the last), are */
+/*   decoded to point 0 and two others: compared with the polynomial's */
+/*   values if it is within the bound, else expected to fail */
+static void
+decodeCase(
+  unsigned int tn
+ ,unsigned int in
+ ,const unsigned char *ip
+ ,const unsigned int *bd
+ ,unsigned int bn
+ ,int dn
+){
+  static struct sssDecode dc;
+  static struct sssPlan pl;
+  unsigned char op[3];
+  unsigned char *cv[256];
+  unsigned char *iv[256];
+  unsigned char *ov[3];
+  unsigned char *rv[3];
+  unsigned int i;
+  size_t ue;
+  size_t k;
+  size_t ln;
+
+  ln = 1000;
+  op[0] = 0;
+  op[1] = *(ip + in - 1) ^ 1;
+  op[2] = 100;
+  for (i = 0; i < tn; ++i) {
+    if (!(cv[i] = malloc(ln)))
+      error("malloc.");
+    fill(cv[i], ln);
+  }
+  for (i = 0; i < in; ++i)
+    if (!(iv[i] = malloc(ln)))
+      error("malloc.");
+  for (i = 0; i < 3; ++i)
+    if (!(ov[i] = malloc(ln)) || !(rv[i] = malloc(ln)))
+      error("malloc.");
+  if (sssPlanPoly(&pl, (unsigned char *)ip, tn, in))
+    error("sssPlanPoly.");
+  sssApply(&pl, cv, iv, ln);
+  if (sssPlanPoly(&pl, op, tn, 3))
+    error("sssPlanPoly.");
+  sssApply(&pl, cv, rv, ln);
+  for (i = 0; i < bn; ++i)
+    for (k = 0; k < ln; ++k)
+      if (dn || rand() & 1 || k == ln - 1)
+        *(iv[*(bd + i)] + k) ^= 1 + rand() % 255;
+  if (sssPlanDecode(&dc, (unsigned char *)ip, op, in, tn, 3))
+    error("sssPlanDecode.");
+  ue = sssDecode(&dc, iv, ov, ln);
+  if (bn <= (in - tn) / 2) {
+    for (i = 0; i < 3 && !memcmp(ov[i], rv[i], ln); ++i);
+    if (ue || i < 3)
+      fail("sssDecode", "auto", in, bn, ln, tn);
+  } else if (!ue)
+    fail("sssDecode", "past bound", in, bn, ln, tn);
+  for (i = 0; i < tn; ++i)
+    free(cv[i]);
+  for (i = 0; i < in; ++i)
+    free(iv[i]);
+  for (i = 0; i < 3; ++i) {
+    free(ov[i]);
+    free(rv[i]);
+  }
+}
+
+/* sssDecode at its bound, past it and with nothing wrong */
+static void
+decode(
+  void
+){
+  static struct sssDecode dc;
+  unsigned char ip[256];
+  unsigned char op[3];
+  unsigned char *iv[256];
+  unsigned char *ov[3];
+  unsigned char *rv[3];
+  unsigned int bd[3];
+  unsigned int i;
+  size_t ue;
+  size_t ln;
+
+  /* 5 of 9 with 2 wrong among the first 5, at the highest points, anywhere */
+  for (i = 0; i < 9; ++i)
+    ip[i] = 1 + i;
+  bd[0] = 0;
+  bd[1] = 3;
+  decodeCase(5, 9, ip, bd, 2, 0);
+  bd[0] = 4;
+  bd[1] = 1;
+  decodeCase(5, 9, ip, bd, 2, 1);
+  for (i = 0; i < 9; ++i)
+    ip[i] = 247 + i;
+  bd[0] = 7;
+  bd[1] = 8;
+  decodeCase(5, 9, ip, bd, 2, 0);
+  points(ip, op, 9, 0);
+  bd[0] = rand() % 9;
+  bd[1] = (bd[0] + 1 + rand() % 8) % 9;
+  decodeCase(5, 9, ip, bd, 2, 0);
+  /* and other thresholds at theirs */
+  points(ip, op, 4, 0);
+  bd[0] = 2;
+  decodeCase(2, 4, ip, bd, 1, 0);
+  points(ip, op, 9, 0);
+  bd[0] = 0;
+  bd[1] = 4;
+  bd[2] = 8;
+  decodeCase(3, 9, ip, bd, 3, 0);
+  /* one wrong share past the bound */
+  for (i = 0; i < 9; ++i)
+    ip[i] = 1 + i;
+  bd[0] = 0;
+  bd[1] = 4;
+  bd[2] = 8;
+  decodeCase(5, 9, ip, bd, 3, 1);
+
+  /* with nothing wrong, sss from the first 5 */
+  ln = 8192 + 129;
+  points(ip, op, 9, 0);
+  op[0] = 0;
+  op[1] = ip[8];
+  op[2] = ip[8] ^ 1;
+  for (i = 0; i < 9; ++i) {
+    if (!(iv[i] = malloc(ln)))
+      error("malloc.");
+    if (i < 5)
+      fill(iv[i], ln);
+  }
+  for (i = 0; i < 3; ++i)
+    if (!(ov[i] = malloc(ln)) || !(rv[i] = malloc(ln)))
+      error("malloc.");
+  sss(ip, ip + 5, iv, iv + 5, 5, 4, ln);
+  sss(ip, op, iv, rv, 5, 3, ln);
+  if (sssPlanDecode(&dc, ip, op, 9, 5, 3))
+    error("sssPlanDecode.");
+  ue = sssDecode(&dc, iv, ov, ln);
+  for (i = 0; i < 3 && !memcmp(ov[i], rv[i], ln); ++i);
+  if (ue || i < 3)
+    fail("sssDecode", "consistent", 9, 0, ln, 5);
+  for (i = 0; i < 9; ++i)
+    free(iv[i]);
+  for (i = 0; i < 3; ++i) {
+    free(ov[i]);
+    free(rv[i]);
+  }
+}
+
+/* as points, of points below 65536 */
+static void
+points16(
+  unsigned short *ip
+ ,unsigned short *op
+ ,unsigned int in
+ ,unsigned int on
+){
+  unsigned int i;
+  unsigned int j;
+
+  for (i = 0; i < in; ++i)
+    do {
+      *(ip + i) = rand();
+      for (j = 0; j < i && *(ip + j) != *(ip + i); ++j);
+    } while (j < i);
+  for (i = 0; i < on; ++i)
+    *(op + i) = in && !(rand() % 4) ? *(ip + rand() % in) : (unsigned short)rand();
+}
+
+/* each sss16 backend against the scalar one */
+static void
+wideBackends(
+  unsigned int in
+ ,unsigned int on
+ ,size_t ln
+ ,size_t al
+){
+  static struct sss16Plan pl;
+  static unsigned short cf[300 * 9];
+  unsigned short ip[300];
+  unsigned short op[9];
+  unsigned short *iv[300];
+  unsigned short *ov[9];
+  unsigned short *rv[9];
+  unsigned int bk;
+  unsigned int i;
+  size_t k;
+
+  points16(ip, op, in, on);
+  for (i = 0; i < in; ++i) {
+    if (!(iv[i] = malloc((ln + al) * sizeof (**iv))))
+      error("malloc.");
+    for (k = 0; k < ln + al; ++k)
+      iv[i][k] = rand();
+  }
+  for (i = 0; i < on; ++i)
+    if (!(ov[i] = malloc((ln + al + 1) * sizeof (**ov)))
+     || !(rv[i] = malloc((ln + al + 1) * sizeof (**rv))))
+      error("malloc.");
+  for (i = 0; i < in; ++i)
+    iv[i] += al;
+  for (i = 0; i < on; ++i) {
+    ov[i] += al;
+    rv[i] += al;
+  }
+  if (sss16Plan(&pl, cf, ip, op, in, on) || sss16Backend(&pl, SSS_SCALAR))
+    error("sss16Plan.");
+  sss16Apply(&pl, iv, rv, ln);
+  for (bk = SSS_SSSE3; bk <= SSS_CT; ++bk) {
+    if (sss16Backend(&pl, bk))
+      continue;
+    for (i = 0; i < on; ++i)
+      memset(ov[i], GUARD, (ln + 1) * sizeof (**ov));
+    sss16Apply(&pl, iv, ov, ln);
+    for (i = 0; i < on; ++i)
+      if (memcmp(ov[i], rv[i], ln * sizeof (**ov)) || ov[i][ln] != (GUARD << 8 | GUARD))
+        break;
+    if (i < on)
+      fail("sss16Apply", Bn[bk], in, on, ln, al);
+  }
+  for (i = 0; i < in; ++i)
+    free(iv[i] - al);
+  for (i = 0; i < on; ++i) {
+    free(ov[i] - al);
+    free(rv[i] - al);
+  }
+}
+
+/* sss16 against sss, a split past 256 shares and its backends against each other */
+static void
+wide(
+  void
+){
+  static struct sss16Plan pl;
+  static unsigned short cf[1000 * 5];
+  unsigned short ip[1000];
+  unsigned short op[1000];
+  unsigned short *iv[1000];
+  unsigned short *ov[1000];
+  unsigned short *rv[16];
+  unsigned char ip8[16];
+  unsigned char op8[16];
+  unsigned char *iv8[16];
+  unsigned char *ov8[16];
+  unsigned int i;
+  unsigned int j;
+  unsigned int l;
+  size_t k;
+  size_t ln;
+
+  /* points and values below 256 are those of sss */
+  ln = 1000;
+  points(ip8, op8, 5, 7);
+  for (i = 0; i < 5; ++i) {
+    if (!(iv8[i] = malloc(ln)) || !(iv[i] = malloc(ln * sizeof (**iv))))
+      error("malloc.");
+    fill(iv8[i], ln);
+    ip[i] = ip8[i];
+    for (k = 0; k < ln; ++k)
+      iv[i][k] = iv8[i][k];
+  }
+  for (i = 0; i < 7; ++i) {
+    if (!(ov8[i] = malloc(ln)) || !(ov[i] = malloc(ln * sizeof (**ov))))
+      error("malloc.");
+    op[i] = op8[i];
+  }
+  sss(ip8, op8, iv8, ov8, 5, 7, ln);
+  if (sss16Plan(&pl, cf, ip, op, 5, 7))
+    error("sss16Plan.");
+  sss16Apply(&pl, iv, ov, ln);
+  for (i = 0; i < 7; ++i)
+    for (k = 0; k < ln; ++k)
+      if (ov[i][k] != ov8[i][k]) {
+        fail("sss16Apply", "subfield", 5, 7, ln, 0);
+        i = 7;
+        break;
+      }
+  for (i = 0; i < 5; ++i) {
+    free(iv8[i]);
+    free(iv[i]);
+  }
+  for (i = 0; i < 7; ++i) {
+    free(ov8[i]);
+    free(ov[i]);
+  }
+
+  /* 1000 shares with threshold 5 of a secret at point 0, */
+  /*   recovered from sets of 5 of them */
+  for (i = 0; i < 5; ++i) {
+    if (!(iv[i] = malloc(ln * sizeof (**iv))))
+      error("malloc.");
+    ip[i] = i;
+    for (k = 0; k < ln; ++k)
+      iv[i][k] = rand();
+  }
+  for (i = 0; i < 1000; ++i) {
+    if (!(ov[i] = malloc(ln * sizeof (**ov))))
+      error("malloc.");
+    op[i] = 1 + i * 65; /* up to 64936 */
+  }
+  if (sss16Plan(&pl, cf, ip, op, 5, 1000))
+    error("sss16Plan.");
+  sss16Apply(&pl, iv, ov, ln);
+  if (!(rv[0] = malloc(ln * sizeof (**rv))))
+    error("malloc.");
+  for (l = 0; l < 20; ++l) {
+    for (i = 0; i < 5; ++i) {
+      do {
+        j = rand() % 1000;
+        ip[5 + i] = op[j];
+        for (k = 0; k < i && ip[5 + k] != ip[5 + i]; ++k);
+      } while (k < i);
+      iv[5 + i] = ov[j];
+    }
+    ip[10] = 0;
+    if (sss16Plan(&pl, cf, ip + 5, ip + 10, 5, 1))
+      error("sss16Plan.");
+    sss16Apply(&pl, iv + 5, rv, ln);
+    if (memcmp(rv[0], iv[0], ln * sizeof (**rv)))
+      fail("sss16Apply", "1000 shares", 5, 1, ln, 0);
+  }
+  free(rv[0]);
+  for (i = 0; i < 5; ++i)
+    free(iv[i]);
+  for (i = 0; i < 1000; ++i)
+    free(ov[i]);
+
+  /* the backends against the scalar one */
+  for (l = 0; l < sizeof (Sh16) / sizeof (Sh16[0]); ++l)
+    for (j = 0; j < sizeof (Ln16) / sizeof (Ln16[0]); ++j)
+      for (k = 0; k < sizeof (Al16) / sizeof (Al16[0]); ++k)
+        wideBackends(Sh16[l][0], Sh16[l][1], Ln16[j], Al16[k]);
+}
+
+int
+main(
+  void
+){
+  srand(1);
+  backends();
+  batch();
+  multi();
+  check();
+  decode();
+  wide();
+  if (Fails) {
+    printf("%u failed\n", Fails);
+    return (1);
+  }
+  return (0);
+}
@@ -122,7 +122,6 @@
 /* Note: your secret sharing system will only be secure provided you
  * feed the program with _cryptographically secure random numbers_. */
 
-/* [This Note is not valid in the below implementation.] */
 /* Note: all input and output files are open simultaneously.  Your
  * system must have enough file descriptors. */
 
@@ -133,13 +132,89 @@
 /* Plea: although I put this file in the Public Domain, I would very
  * much appreciate getting credit if credit is due.  Thank you. */
 
+/* Inputs are read, and outputs written, a chunk at a time, so any
+ * size can be done in a fixed amount of memory.  The length is set
+ * by the first input, which can be a pipe. */
+
+/* Options:
+ * --threads=N  compute with N threads
+ * --chunk=N    bytes of each file in memory at a time (default 1MB)
+ * --mmap       map the files instead, inputs must be regular files
+ * --pipe       read the next chunk and write the last chunk while
+ *              computing this one, with a reader and a writer thread
+ * --threshold=M  split the only input into shares needing M to recover
+ *              generating the M-1 random inputs (at the lowest points
+ *              other than the secret's) from a key read from /dev/urandom
+ * --poly       with --threshold, use the secret and random values as the
+ *              coefficients of the polynomial, forgoing the interpolation,
+ *              the point given the secret is ignored; without, the inputs
+ *              are the coefficients, at points 0 to M-1 in order
+ * --coef       the outputs, at points 0 to M-1 in order for M inputs, are
+ *              the coefficients of the inputs' polynomial, for --poly
+ * --reshare=T  the inputs are shares, the outputs new shares needing T
+ *              to recover (at points other than 0), done without
+ *              recovering the secret, with T-1 random values generated
+ *              from a key read from /dev/urandom
+ * --range=A:B  only bytes A up to B of the inputs (to the end if B is
+ *              left out), which must then be files that can be seeked
+ * --container  inputs and outputs at points other than 0 are shares in
+ *              containers (below) that are checked as they are read
+ * --check=M    check that the inputs, shares needing M to recover, are
+ *              of one value, with no outputs; the byte ranges that are
+ *              not are printed with the share that is wrong if one share
+ *              explains it, and the exit status is then 1
+ * --decode=M   the inputs are shares needing M to recover of which up to
+ *              half of those beyond M may be wrong, the bytes where they
+ *              are not consistent are corrected (without threads)
+ * --stats      print the time reading, computing and writing at the end
+ *              and, when sss.c is built with SSS_STATS 1, its counters
+ * --numa       with --threads, pin the threads to the NUMA nodes in turn
+ *              (Linux), each node computing the chunks of its part of the
+ *              buffers, whose pages it touches first (so they are not huge
+ *              pages), with its own copy of the plan, and taking chunks
+ *              from the others when done */
+
+/* A container is a header of
+ *   4 bytes "SSSC", 1 byte version (2), 1 byte point, 2 bytes threshold,
+ *   4 bytes chunk size, 8 bytes length of the value (~0 if not known),
+ *   4 bytes CRC32C of the 20 bytes before
+ * then each chunk of the value followed by its 4 byte CRC32C, all but the
+ * last chunk of chunk size bytes and all numbers little endian.  A chunk's
+ * CRC32C starts from that of the first 12 bytes of the header followed by
+ * the chunk's 8 byte index, so a chunk is only good at its place in its
+ * share.  A bad share is rejected at the first bad chunk, and a range
+ * starts at its chunk.  The length is filled in when the output can be
+ * seeked. */
+
+#define _FILE_OFFSET_BITS 64 /* files over 2GB on 32 bit systems */
+#if defined(__linux__)
+#define _GNU_SOURCE /* thread affinity */
+#endif
+
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <time.h>
 #include <fcntl.h>
 #include <unistd.h>
 #include <sys/stat.h>
+#include <sys/mman.h>
+#include <pthread.h>
+#if defined(__linux__)
+#include <sched.h>
+#define NUMA 1
+#else
+#define NUMA 0
+#endif
 #include "sss.h"
 
+#if defined(__GNUC__) && defined(__x86_64__)
+#define CRC_X86 1
+#include <nmmintrin.h>
+#else
+#define CRC_X86 0
+#endif
+
 static void
 error(
   const char *errmsg
@@ -148,33 +223,1097 @@ error(
   exit(EXIT_FAILURE);
 }
 
+static const char *Bn[] = { "scalar", "ssse3", "avx2", "avx512", "neon", "ct" };
+
+/* with --stats, nanoseconds and bytes of each, each only from one thread */
+static struct {
+  int on;
+  unsigned long long rt; /* reading */
+  unsigned long long ct; /* computing */
+  unsigned long long wt; /* writing */
+  unsigned long long rb;
+  unsigned long long wb;
+} Stats;
+
+static unsigned long long
+now(
+  void
+){
+  struct timespec t;
+
+  if (!Stats.on)
+    return (0);
+  clock_gettime(CLOCK_MONOTONIC, &t);
+  return (t.tv_sec * 1000000000ULL + t.tv_nsec);
+}
+
+/* CRC32C (Castagnoli) */
+static unsigned int Crc[256];
+
+static void
+crcInit(
+  void
+){
+  unsigned int i;
+  unsigned int k;
+  unsigned int c;
+
+  for (i = 0; i < 256; ++i) {
+    for (c = i, k = 0; k < 8; ++k)
+      c = c & 1 ? c >> 1 ^ 0x82f63b78 : c >> 1;
+    Crc[i] = c;
+  }
+}
+
+#if CRC_X86
+__attribute__((target("sse4.2")))
+static unsigned int
+crcSse42(
+  unsigned int c
+ ,const unsigned char *b
+ ,size_t n
+){
+  unsigned long long x;
+  size_t k;
+
+  for (k = 0; k + 8 <= n; k += 8) {
+    memcpy(&x, b + k, 8);
+    c = _mm_crc32_u64(c, x);
+  }
+  for (; k < n; ++k)
+    c = _mm_crc32_u8(c, *(b + k));
+  return (c);
+}
+#endif
+
+/* CRC32C of n bytes following those c is the CRC32C of (0 to start) */
+static unsigned int
+crc(
+  unsigned int c
+ ,const unsigned char *b
+ ,size_t n
+){
+  size_t k;
+
+  c = ~c;
+#if CRC_X86
+  if (__builtin_cpu_supports("sse4.2"))
+    return (~crcSse42(c, b, n));
+#endif
+  for (k = 0; k < n; ++k)
+    c = Crc[(c ^ *(b + k)) & 0xff] ^ c >> 8;
+  return (~c);
+}
+
+static void
+putle(
+  unsigned char *b
+ ,unsigned long long v
+ ,unsigned int n
+){
+  for (; n; --n, v >>= 8)
+    *b++ = v;
+}
+
+static unsigned long long
+getle(
+  const unsigned char *b
+ ,unsigned int n
+){
+  unsigned long long v;
+
+  for (v = 0; n; --n)
+    v = v << 8 | *(b + n - 1);
+  return (v);
+}
+
+#define NM_MAX 64 /* most NUMA nodes used */
+
+/* a pool of threads that is the executor for sssParallel */
+/*   the chunks are split among the nodes in order, each thread does those */
+/*   of its node and, if st, then takes from the end of another's */
+struct pool {
+  pthread_mutex_t mx;
+  pthread_cond_t wk; /* work posted */
+  pthread_cond_t dn; /* work done */
+  void (*fn)(void *, unsigned int);
+  void *ar;
+  unsigned int cn; /* number of chunks */
+  unsigned int nx[NM_MAX]; /* next chunk of each node */
+  unsigned int ne[NM_MAX]; /* end of the chunks of each node */
+  unsigned int bz; /* chunks in progress */
+  unsigned int th; /* number of threads */
+  unsigned int nn; /* number of nodes, 1 without --numa */
+  int nm; /* --numa, the caller does no chunks */
+  int st; /* chunks can be taken by other nodes */
+  size_t cs; /* with --numa, chunk size of the placed buffers, 0 if none */
+  struct member {
+    struct pool *p;
+    unsigned int nd; /* node */
+  } *mb;
+  struct sssPlan *pl[NM_MAX]; /* copy of the plan on each node, with --numa */
+};
+
+/* the node of chunk ck of cn */
+static unsigned int
+home(
+  struct pool *p
+ ,unsigned int ck
+){
+  return ((unsigned long long)ck * p->nn / p->cn);
+}
+
+/* a chunk for node nd, its own or another's, ~0 if none */
+static unsigned int
+take(
+  struct pool *p
+ ,unsigned int nd
+){
+  unsigned int m;
+  unsigned int n;
+
+  if (p->nx[nd] < p->ne[nd])
+    return (p->nx[nd]++);
+  if (!p->st)
+    return (~0U);
+  /* the end of the node with the most left */
+  for (m = nd, n = 0; n < p->nn; ++n)
+    if (p->ne[n] - p->nx[n] > p->ne[m] - p->nx[m])
+      m = n;
+  return (p->nx[m] < p->ne[m] ? --p->ne[m] : ~0U);
+}
+
+static int
+left(
+  struct pool *p
+){
+  unsigned int n;
+
+  for (n = 0; n < p->nn && p->nx[n] >= p->ne[n]; ++n);
+  return (n < p->nn);
+}
+
+static void
+run(
+  struct pool *p
+ ,unsigned int nd
+){
+  unsigned int ck;
+
+  while ((ck = take(p, nd)) != ~0U) {
+    ++p->bz;
+    pthread_mutex_unlock(&p->mx);
+    p->fn(p->ar, ck);
+    pthread_mutex_lock(&p->mx);
+    if (!--p->bz && !left(p))
+      pthread_cond_signal(&p->dn);
+  }
+}
+
+static void *
+worker(
+  void *v
+){
+  struct member *m;
+  struct pool *p;
+
+  m = v;
+  p = m->p;
+  pthread_mutex_lock(&p->mx);
+  for (;;) {
+    while (p->nx[m->nd] >= p->ne[m->nd] && (!p->st || !left(p)))
+      pthread_cond_wait(&p->wk, &p->mx);
+    run(p, m->nd);
+  }
+  return (0);
+}
+
+static void
+execute(
+  void *cx
+ ,void (*fn)(void *, unsigned int)
+ ,void *ar
+ ,unsigned int cn
+){
+  struct pool *p;
+  unsigned int n;
+
+  p = cx;
+  pthread_mutex_lock(&p->mx);
+  p->fn = fn;
+  p->ar = ar;
+  p->cn = cn;
+  for (n = 0; n < p->nn; ++n) {
+    p->nx[n] = ((unsigned long long)n * cn + p->nn - 1) / p->nn;
+    p->ne[n] = ((unsigned long long)(n + 1) * cn + p->nn - 1) / p->nn;
+  }
+  pthread_cond_broadcast(&p->wk);
+  if (!p->nm)
+    run(p, 0);
+  while (p->bz || left(p))
+    pthread_cond_wait(&p->dn, &p->mx);
+  pthread_mutex_unlock(&p->mx);
+}
+
+#if NUMA
+/* the numbers in a list like 0-3,8 in file fn, returns how many */
+static unsigned int
+numbers(
+  const char *fn
+ ,unsigned int *v
+ ,unsigned int n
+){
+  char b[4096];
+  unsigned int i;
+  unsigned int a;
+  unsigned int z;
+  char *s;
+  char *e;
+  ssize_t r;
+  int fd;
+
+  if ((fd = open(fn, O_RDONLY)) < 0)
+    return (0);
+  r = read(fd, b, sizeof (b) - 1);
+  close(fd);
+  b[r > 0 ? r : 0] = '\0';
+  for (i = 0, s = b; *s >= '0' && *s <= '9';) {
+    a = z = strtoul(s, &e, 10);
+    if (*e == '-')
+      z = strtoul(e + 1, &e, 10);
+    for (; a <= z && i < n; ++a)
+      *(v + i++) = a;
+    if (*e != ',')
+      break;
+    s = e + 1;
+  }
+  return (i);
+}
+#endif
+
+static void
+poolInit(
+  struct pool *p
+ ,unsigned int th
+ ,int nm
+){
+  pthread_attr_t at;
+  pthread_t t;
+  unsigned int k;
+#if NUMA
+  static cpu_set_t cs[NM_MAX];
+  unsigned int v[CPU_SETSIZE];
+  unsigned int nd[NM_MAX];
+  char fn[64];
+  unsigned int i;
+  unsigned int n;
+#endif
+
+  pthread_mutex_init(&p->mx, 0);
+  pthread_cond_init(&p->wk, 0);
+  pthread_cond_init(&p->dn, 0);
+  p->cn = p->bz = 0;
+  p->nx[0] = p->ne[0] = 0;
+  p->th = th;
+  p->nn = 1;
+  p->nm = nm;
+  p->st = 0;
+  p->cs = 0;
+  if (!(p->mb = malloc(th * sizeof (*p->mb))))
+    error("malloc.");
+  if (nm) {
+#if NUMA
+    /* the nodes with cpus, no more than the threads */
+    n = numbers("/sys/devices/system/node/online", nd, NM_MAX);
+    for (p->nn = 0, k = 0; k < n && p->nn < th; ++k) {
+      sprintf(fn, "/sys/devices/system/node/node%u/cpulist", nd[k]);
+      CPU_ZERO(cs + p->nn);
+      for (i = numbers(fn, v, CPU_SETSIZE); i--;)
+        CPU_SET(v[i], cs + p->nn);
+      if (CPU_COUNT(cs + p->nn))
+        ++p->nn;
+    }
+    if (!p->nn)
+      error("No NUMA nodes.");
+    p->st = 1;
+#else
+    error("--numa is not supported on this system.");
+#endif
+  }
+  for (k = 0; k < p->nn; ++k)
+    p->pl[k] = 0;
+  /* the caller is a thread too, except with --numa */
+  for (k = !nm; k < th; ++k) {
+    (p->mb + k)->p = p;
+    (p->mb + k)->nd = k % p->nn;
+    pthread_attr_init(&at);
+#if NUMA
+    if (nm && pthread_attr_setaffinity_np(&at, sizeof (cs[0]), cs + k % p->nn))
+      error("pthread_attr_setaffinity_np.");
+#endif
+    if (pthread_create(&t, &at, worker, p->mb + k))
+      error("pthread_create.");
+    pthread_attr_destroy(&at);
+  }
+}
+
+/* with --numa, chunks of the buffers as sssParallel does them, but with */
+/*   the plan of the chunk's node */
+struct spread {
+  struct pool *pool;
+  struct sssPlan *pl;
+  unsigned char **iv;
+  unsigned char **ov;
+  size_t ln;
+  size_t cs; /* chunk size */
+};
+
+static void
+spread(
+  void *ar
+ ,unsigned int ck
+){
+  unsigned char *vv[256];
+  unsigned char *ww[256];
+  struct spread *s;
+  unsigned int k;
+  size_t of;
+
+  s = ar;
+  if ((of = (size_t)ck * s->cs) >= s->ln)
+    return;
+  for (k = 0; k < s->pl->in; ++k)
+    vv[k] = *(s->iv + k) + of;
+  for (k = 0; k < s->pl->on; ++k)
+    ww[k] = *(s->ov + k) + of;
+  sssApply(*(s->pool->pl + home(s->pool, ck)), vv, ww, s->ln - of < s->cs ? s->ln - of : s->cs);
+}
+
+/* the chunks of sssSplit, each a stretch of the value at its offset */
+struct split {
+  struct spread s;
+  const unsigned char *ky;
+  unsigned int vn; /* number of inputs given */
+  unsigned long long ps; /* position of the buffers in the value */
+};
+
+static void
+split(
+  void *ar
+ ,unsigned int ck
+){
+  unsigned char *vv[256];
+  unsigned char *ww[256];
+  struct split *p;
+  unsigned int k;
+  size_t of;
+
+  p = ar;
+  if ((of = (size_t)ck * p->s.cs) >= p->s.ln)
+    return;
+  for (k = 0; k < p->vn; ++k)
+    vv[k] = *(p->s.iv + k) + of;
+  for (k = 0; k < p->s.pl->on; ++k)
+    ww[k] = *(p->s.ov + k) + of;
+  sssSplit(p->s.pl, p->ky, vv, ww, p->vn, p->ps + of, p->s.ln - of < p->s.cs ? p->s.ln - of : p->s.cs);
+}
+
+/* first touch of the chunks' pages by their nodes, and the plan copies */
+static void
+touch(
+  void *ar
+ ,unsigned int ck
+){
+  struct spread *s;
+  unsigned int nd;
+  unsigned int k;
+  size_t of;
+
+  s = ar;
+  nd = home(s->pool, ck);
+  if (!ck || home(s->pool, ck - 1) != nd)
+    memcpy(*(s->pool->pl + nd), s->pl, sizeof (*s->pl));
+  if ((of = (size_t)ck * s->cs) >= s->ln)
+    return;
+  for (k = 0; k < s->pl->in; ++k)
+    memset(*(s->iv + k) + of, 0, s->ln - of < s->cs ? s->ln - of : s->cs);
+  for (k = 0; k < s->pl->on; ++k)
+    memset(*(s->ov + k) + of, 0, s->ln - of < s->cs ? s->ln - of : s->cs);
+}
+
+/* the chunks of ln bytes for sssParallel and spread, those of place if */
+/*   the buffers were placed, so a short one is split where it was touched */
+static struct spread *
+chunks(
+  struct spread *s
+ ,struct pool *pool
+ ,struct sssPlan *pl
+ ,unsigned char **iv
+ ,unsigned char **ov
+ ,size_t ln
+){
+  unsigned int cn;
+
+  cn = pool->th * 4;
+  s->pool = pool;
+  s->pl = pl;
+  s->iv = iv;
+  s->ov = ov;
+  s->ln = ln;
+  s->cs = pool->cs ? pool->cs : ((ln / cn + (ln % cn != 0)) + 63) & ~(size_t)63;
+  return (s);
+}
+
+/* with --numa, the plan copied to the nodes and the buffers of ln bytes */
+/*   (none if 0) touched by the nodes that do them, in chunks of pages */
+static void
+place(
+  struct pool *pool
+ ,struct sssPlan *pl
+ ,unsigned char **iv
+ ,unsigned char **ov
+ ,size_t ln
+){
+  struct spread s;
+  unsigned int cn;
+  unsigned int k;
+  size_t pg;
+
+  for (k = 0; k < pool->nn; ++k)
+    if (!pool->pl[k] && (pool->pl[k] = mmap(0, sizeof (*pl), PROT_READ | PROT_WRITE
+     ,MAP_PRIVATE | MAP_ANONYMOUS, -1, 0)) == MAP_FAILED)
+      error("mmap.");
+  if (ln) {
+    cn = pool->th * 4;
+    pg = sysconf(_SC_PAGESIZE);
+    pool->cs = ((ln / cn + (ln % cn != 0)) + pg - 1) / pg * pg;
+  }
+  /* each node's own chunks */
+  pool->st = 0;
+  execute(pool, touch, chunks(&s, pool, pl, iv, ov, ln), pool->th * 4);
+  pool->st = 1;
+}
+
+/* read up to n bytes, returns less only at end of file */
+static size_t
+fill(
+  int fd
+ ,unsigned char *b
+ ,size_t n
+){
+  size_t k;
+  ssize_t r;
+
+  for (k = 0; k < n; k += r)
+    if ((r = read(fd, b + k, n - k)) <= 0) {
+      if (!r)
+        break;
+      error("read.");
+    }
+  return (k);
+}
+
+static void
+drain(
+  int fd
+ ,const unsigned char *b
+ ,size_t n
+){
+  size_t k;
+  ssize_t r;
+
+  for (k = 0; k < n; k += r)
+    if ((r = write(fd, b + k, n - k)) <= 0)
+      error("write.");
+}
+
+#define HD_LN 24 /* container header length */
+
+/* a share in a container */
+struct share {
+  int fd;
+  unsigned int pt; /* point */
+  unsigned int tn; /* threshold */
+  size_t cs; /* chunk size */
+  unsigned long long ln; /* length of the value, ~0 if not known */
+  unsigned long long ps; /* position of the chunk */
+  unsigned int cr; /* CRC32C of the chunk so far, writing */
+  unsigned char *cb; /* the chunk and its CRC32C, reading */
+  size_t cl; /* bytes of the chunk */
+  size_t co; /* bytes of the chunk used */
+};
+
+static void
+header(
+  struct share *sh
+ ,unsigned char *h
+){
+  memcpy(h, "SSSC", 4);
+  *(h + 4) = 2;
+  *(h + 5) = sh->pt;
+  putle(h + 6, sh->tn, 2);
+  putle(h + 8, sh->cs, 4);
+  putle(h + 12, sh->ln, 8);
+  putle(h + 20, crc(0, h, 20), 4);
+}
+
+/* the CRC32C chunk ck of a share starts from */
+static unsigned int
+seed(
+  struct share *sh
+ ,unsigned long long ck
+){
+  unsigned char h[HD_LN];
+
+  header(sh, h);
+  putle(h + 12, ck, 8);
+  return (crc(0, h, 20));
+}
+
+/* read and check the header */
+static void
+openShare(
+  struct share *sh
+ ,int fd
+){
+  unsigned char h[HD_LN];
+
+  sh->fd = fd;
+  if (fill(fd, h, HD_LN) != HD_LN || memcmp(h, "SSSC", 4) || *(h + 4) != 2
+   || getle(h + 20, 4) != crc(0, h, 20) || !(sh->cs = getle(h + 8, 4)) || !getle(h + 6, 2))
+    error("An input is not a share.");
+  sh->pt = *(h + 5);
+  sh->tn = getle(h + 6, 2);
+  sh->ln = getle(h + 12, 8);
+  sh->ps = sh->cl = sh->co = 0;
+  if (!(sh->cb = malloc(sh->cs + 4)))
+    error("malloc.");
+}
+
+/* read the next chunk and check it, returns its length */
+static size_t
+load(
+  struct share *sh
+){
+  size_t r;
+
+  sh->ps += sh->cl;
+  sh->cl = sh->co = 0;
+  if (!(r = fill(sh->fd, sh->cb, sh->cs + 4))) {
+    if (sh->ln != ~0ULL && sh->ps != sh->ln)
+      error("A share is too short.");
+    return (0);
+  }
+  if (r < 4 || getle(sh->cb + r - 4, 4) != crc(seed(sh, sh->ps / sh->cs), sh->cb, r - 4)
+   || (sh->ln != ~0ULL && sh->ps + r - 4 > sh->ln))
+    error("A share is corrupt.");
+  return (sh->cl = r - 4);
+}
+
+/* fill from a share */
+static size_t
+get(
+  struct share *sh
+ ,unsigned char *b
+ ,size_t n
+){
+  size_t k;
+  size_t t;
+
+  for (k = 0; k < n; k += t) {
+    if (sh->co == sh->cl && !load(sh))
+      break;
+    t = sh->cl - sh->co < n - k ? sh->cl - sh->co : n - k;
+    memcpy(b + k, sh->cb + sh->co, t);
+    sh->co += t;
+  }
+  return (k);
+}
+
+/* start reading a share at ps of the value */
+static void
+seekShare(
+  struct share *sh
+ ,unsigned long long ps
+){
+  unsigned long long q;
+
+  q = ps / sh->cs;
+  if (lseek(sh->fd, HD_LN + q * (sh->cs + 4), SEEK_SET) == (off_t)-1)
+    error("--range needs inputs that can be seeked.");
+  sh->ps = q * sh->cs;
+  sh->cl = 0;
+  load(sh);
+  sh->co = ps - sh->ps < sh->cl ? ps - sh->ps : sh->cl;
+}
+
+/* write the header, with the length not yet known */
+static void
+createShare(
+  struct share *sh
+ ,int fd
+){
+  unsigned char h[HD_LN];
+
+  sh->fd = fd;
+  sh->ln = ~0ULL;
+  sh->ps = 0;
+  sh->cr = seed(sh, 0);
+  header(sh, h);
+  drain(fd, h, HD_LN);
+}
+
+/* drain to a share, each whole chunk followed by its CRC32C */
+static void
+put(
+  struct share *sh
+ ,const unsigned char *b
+ ,size_t n
+){
+  unsigned char c[4];
+  size_t t;
+
+  for (; n; b += t, n -= t) {
+    t = sh->cs - sh->ps % sh->cs < n ? sh->cs - sh->ps % sh->cs : n;
+    drain(sh->fd, b, t);
+    sh->cr = crc(sh->cr, b, t);
+    if (!((sh->ps += t) % sh->cs)) {
+      putle(c, sh->cr, 4);
+      drain(sh->fd, c, 4);
+      sh->cr = seed(sh, sh->ps / sh->cs);
+    }
+  }
+}
+
+/* the last chunk's CRC32C and, if it can be seeked, the length */
+static void
+closeShare(
+  struct share *sh
+){
+  unsigned char h[HD_LN];
+
+  if (sh->ps % sh->cs) {
+    putle(h, sh->cr, 4);
+    drain(sh->fd, h, 4);
+  }
+  sh->ln = sh->ps;
+  header(sh, h);
+  if (lseek(sh->fd, 0, SEEK_CUR) != (off_t)-1 && pwrite(sh->fd, h, HD_LN, 0) != HD_LN)
+    error("write.");
+}
+
+/* fill from and drain to files or shares (a share if sh is not 0) */
+static size_t
+input(
+  struct share *sh
+ ,int fd
+ ,unsigned char *b
+ ,size_t n
+){
+  unsigned long long t;
+
+  t = now();
+  n = sh ? get(sh, b, n) : fill(fd, b, n);
+  Stats.rt += now() - t;
+  Stats.rb += n;
+  return (n);
+}
+
+static void
+output(
+  struct share *sh
+ ,int fd
+ ,const unsigned char *b
+ ,size_t n
+){
+  unsigned long long t;
+
+  t = now();
+  if (sh)
+    put(sh, b, n);
+  else
+    drain(fd, b, n);
+  Stats.wt += now() - t;
+  Stats.wb += n;
+}
+
+#define CK_BS 4096 /* bytes of a block checked */
+#define CK_BN 256 /* blocks checked at a time */
+
+/* checking, a run of blocks with the same result is printed once */
+struct verify {
+  const unsigned char *ip;
+  unsigned long long a; /* the run */
+  unsigned long long b;
+  unsigned int v; /* its result from sssCheck */
+  unsigned int bd[CK_BN];
+  int bad;
+};
+
+static void
+result(
+  struct verify *vf
+ ,unsigned long long ps
+ ,size_t ln
+ ,unsigned int v
+){
+  if (vf->v && (v != vf->v || ps != vf->b)) {
+    if (vf->v == ~0U)
+      printf("bytes %llu to %llu: the shares are not of one value\n", vf->a, vf->b);
+    else
+      printf("bytes %llu to %llu: share %u is wrong\n", vf->a, vf->b, *(vf->ip + vf->v - 1));
+    vf->bad = 1;
+  }
+  if (v != vf->v || ps != vf->b)
+    vf->a = ps;
+  vf->v = v;
+  vf->b = ps + ln;
+}
+
+static void
+verify(
+  struct sssPlan *pl
+ ,struct verify *vf
+ ,unsigned char **iv
+ ,unsigned long long ps
+ ,size_t ln
+){
+  unsigned char *vv[256];
+  unsigned int j;
+  size_t k;
+  size_t t;
+  size_t b;
+
+  for (k = 0; k < ln; k += t) {
+    t = ln - k < CK_BS * CK_BN ? ln - k : CK_BS * CK_BN;
+    for (j = 0; j < pl->in; ++j)
+      vv[j] = *(iv + j) + k;
+    if (!sssCheck(pl, vv, t, CK_BS, vf->bd)) {
+      result(vf, ps + k, t, 0);
+      continue;
+    }
+    for (b = 0; b * CK_BS < t; ++b)
+      result(vf, ps + k + b * CK_BS, t - b * CK_BS < CK_BS ? t - b * CK_BS : CK_BS, vf->bd[b]);
+  }
+}
+
+/* a stretch of the values, ps bytes into them */
+/*   returns the number of bytes that could not be decoded */
+static size_t
+compute(
+  struct sssPlan *pl
+ ,struct pool *pool /* 0 if not threaded */
+ ,const unsigned char *ky /* 0 if not splitting */
+ ,struct verify *vf /* 0 if not checking */
+ ,struct sssDecode *dc /* 0 if not decoding */
+ ,unsigned char **iv
+ ,unsigned char **ov
+ ,unsigned int vn
+ ,unsigned long long ps
+ ,size_t ln
+){
+  unsigned long long t;
+  size_t ue;
+
+  t = now();
+  ue = 0;
+  if (dc)
+    ue = sssDecode(dc, iv, ov, ln);
+  else if (vf)
+    verify(pl, vf, iv, ps, ln);
+  else if (ky && pool) {
+    struct split p;
+
+    chunks(&p.s, pool, pl, iv, ov, ln);
+    p.ky = ky;
+    p.vn = vn;
+    p.ps = ps;
+    execute(pool, split, &p, pool->th * 4);
+  } else if (ky)
+    sssSplit(pl, ky, iv, ov, vn, ps, ln);
+  else if (pool && pool->nm) {
+    struct spread s;
+
+    execute(pool, spread, chunks(&s, pool, pl, iv, ov, ln), pool->th * 4);
+  } else if (pool)
+    sssParallel(pl, iv, ov, ln, pool->th * 4, execute, pool);
+  else
+    sssApply(pl, iv, ov, ln);
+  Stats.ct += now() - t;
+  return (ue);
+}
+
+static void
+report(
+  unsigned int th /* threads that computed */
+){
+  struct sssStats st;
+  unsigned int k;
+
+  fprintf(stderr, "read %llu bytes in %.3f ms, computed in %.3f ms, wrote %llu bytes in %.3f ms with %u threads\n"
+   ,Stats.rb, Stats.rt / 1e6, Stats.ct / 1e6, Stats.wb, Stats.wt / 1e6, th);
+  if (sssStats(&st, 0))
+    return;
+  fprintf(stderr, "%llu plans in %.3f ms, %llu applies of %llu bytes in %.3f ms, %llu bytes copied, last %s in %u chunks\n"
+   ,st.pn, st.pt / 1e6, st.kn, st.kb, st.kt / 1e6, st.cb, Bn[st.bk], st.cn ? st.cn : 1);
+  for (k = 0; k < sizeof (Bn) / sizeof (Bn[0]); ++k)
+    if (st.bb[k])
+      fprintf(stderr, "%s: %llu bytes\n", Bn[k], st.bb[k]);
+}
+
+/* map ln bytes of a file from ps */
+static unsigned char *
+map(
+  int fd
+ ,unsigned long long ps
+ ,size_t ln
+ ,int pr
+){
+  unsigned char *v;
+  size_t pg;
+
+  /* the mapping starts on a page */
+  pg = ps % sysconf(_SC_PAGESIZE);
+  if ((v = mmap(0, ln + pg, pr, MAP_SHARED, fd, ps - pg)) == MAP_FAILED)
+    error("mmap.");
+  madvise(v, ln + pg, MADV_SEQUENTIAL);
+  return (v + pg);
+}
+
+/* one allocation for bn buffers of bs bytes, each on a 64 byte line */
+/*   or if pg (with --numa) on pages, not huge ones, so place can put */
+/*   each chunk's pages on its node */
+/*   returns the arena and the bytes between buffers in bs */
+static unsigned char *
+arena(
+  size_t bn
+ ,size_t *bs
+ ,int pg
+){
+  size_t al;
+  void *v;
+
+  al = pg ? (size_t)sysconf(_SC_PAGESIZE) : 64;
+  *bs = (*bs + al - 1) / al * al;
+  if (!*bs || bn > ~(size_t)0 / *bs)
+    error("Bad chunk size.");
+  if (posix_memalign(&v, al, bn * *bs))
+    error("malloc.");
+#ifdef MADV_HUGEPAGE
+  /* a large arena can be on huge pages */
+  madvise(v, bn * *bs, pg ? MADV_NOHUGEPAGE : MADV_HUGEPAGE);
+#endif
+  return (v);
+}
+
+/* a chunk moving through the reader, compute and writer */
+struct slot {
+  unsigned char *iv[256];
+  unsigned char *ov[256];
+  unsigned long long ps; /* position of the chunk */
+  size_t ln; /* length of the chunk, 0 at the end */
+  unsigned int st; /* 0 free, 1 read, 2 computed */
+};
+
+/* three slots, so one can be read, one computed and one written */
+struct pipeline {
+  pthread_mutex_t mx;
+  pthread_cond_t cv;
+  struct slot sl[3];
+  int *id;
+  int *od;
+  struct share **is; /* 0 or the share of input k */
+  struct share **os;
+  unsigned int vn;
+  unsigned int on;
+  size_t cs;
+  unsigned long long ps; /* position of the first chunk */
+  unsigned long long rm; /* bytes left to read */
+};
+
+static struct slot *
+await(
+  struct pipeline *p
+ ,unsigned int n
+ ,unsigned int st
+){
+  struct slot *s;
+
+  s = p->sl + n % 3;
+  pthread_mutex_lock(&p->mx);
+  while (s->st != st)
+    pthread_cond_wait(&p->cv, &p->mx);
+  pthread_mutex_unlock(&p->mx);
+  return (s);
+}
+
+static void
+post(
+  struct pipeline *p
+ ,struct slot *s
+ ,unsigned int st
+){
+  pthread_mutex_lock(&p->mx);
+  s->st = st;
+  pthread_cond_broadcast(&p->cv);
+  pthread_mutex_unlock(&p->mx);
+}
+
+static void *
+reader(
+  void *v
+){
+  struct pipeline *p;
+  struct slot *s;
+  unsigned long long ps;
+  unsigned int n;
+  unsigned int k;
+
+  p = v;
+  for (ps = p->ps, n = 0;; ps += s->ln, p->rm -= s->ln, ++n) {
+    s = await(p, n, 0);
+    s->ps = ps;
+    if ((s->ln = input(*p->is, *p->id, *s->iv, p->cs < p->rm ? p->cs : p->rm)))
+      for (k = 1; k < p->vn; ++k)
+        if (input(*(p->is + k), *(p->id + k), *(s->iv + k), s->ln) != s->ln)
+          error("an input file is too small.");
+    post(p, s, 1);
+    if (!s->ln)
+      return (0);
+  }
+}
+
+static void *
+writer(
+  void *v
+){
+  struct pipeline *p;
+  struct slot *s;
+  unsigned int n;
+  unsigned int k;
+
+  p = v;
+  for (n = 0;; ++n) {
+    s = await(p, n, 2);
+    if (!s->ln)
+      return (0);
+    for (k = 0; k < p->on; ++k)
+      output(*(p->os + k), *(p->od + k), *(s->ov + k), s->ln);
+    post(p, s, 0);
+  }
+}
+
 int
 main(
   int argc
  ,const char *argv[]
 ){
-  const char **of;
-  unsigned char *ip;
-  unsigned char *op;
-  unsigned char **iv;
-  unsigned char **ov;
+  struct pool pool;
+  struct sssPlan pl;
+  struct sssDecode dc;
+  struct verify vf;
+  const char *of[256];
+  struct share *is[256];
+  struct share *os[256];
+  int id[256];
+  int od[256];
+  unsigned char ip[256];
+  unsigned char op[256];
+  unsigned char *iv[256];
+  unsigned char *ov[256];
+  unsigned char ky[32];
+  unsigned char *ab;
+  unsigned long long ps;
+  unsigned long long ue;
+  unsigned long long ra;
+  unsigned long long rb;
   unsigned int in;
+  unsigned int vn;
   unsigned int on;
-  unsigned int ln;
+  unsigned int tm;
+  unsigned int rs;
+  unsigned int ck;
+  unsigned int dn;
+  unsigned int tn;
+  int ct;
+  int cf;
+  int nu;
+  int pp;
+  int mm;
+  int py;
+  size_t cs;
+  size_t ln;
+  unsigned int th;
   unsigned int k;
 
-  of = 0;
-  ip = op = 0;
-  iv = ov = 0;
+  sssInit();
+  crcInit();
+  th = 1;
+  tm = 0;
+  rs = 0;
+  ck = 0;
+  dn = 0;
+  ct = 0;
+  cf = 0;
+  nu = 0;
+  py = 0;
+  mm = 0;
+  pp = 0;
+  cs = 1 << 20;
+  ra = 0;
+  rb = ~0ULL;
+  ab = 0;
   in = on = 0;
-  ln = 0;
   /* Read command line arguments */
   for (k = 1; k < (unsigned int)argc; ++k) {
-    void *v;
-    unsigned int s;
     int l;
     int p;
 
+    if (argv[k][0] == '-' && argv[k][1] == '-') {
+      if (!strncmp(argv[k] + 2, "threads=", 8)) {
+        if (!(th = atoi(argv[k] + 10)) || th > 1024)
+          error("Bad thread count.");
+      } else if (!strncmp(argv[k] + 2, "threshold=", 10)) {
+        if ((tm = atoi(argv[k] + 12)) < 2 || tm > 256)
+          error("Bad threshold.");
+      } else if (!strncmp(argv[k] + 2, "reshare=", 8)) {
+        if ((rs = atoi(argv[k] + 10)) < 2 || rs > 256)
+          error("Bad threshold.");
+      } else if (!strncmp(argv[k] + 2, "range=", 6)) {
+        char *e;
+
+        ra = strtoull(argv[k] + 8, &e, 10);
+        if (e == argv[k] + 8 || *e++ != ':')
+          error("Bad range.");
+        if (*e && ((rb = strtoull(e, &e, 10)) < ra || *e))
+          error("Bad range.");
+      } else if (!strcmp(argv[k] + 2, "pipe")) {
+        pp = 1;
+      } else if (!strncmp(argv[k] + 2, "check=", 6)) {
+        if ((ck = atoi(argv[k] + 8)) < 1 || ck > 255)
+          error("Bad threshold.");
+      } else if (!strncmp(argv[k] + 2, "decode=", 7)) {
+        if ((dn = atoi(argv[k] + 9)) < 1 || dn > 256)
+          error("Bad threshold.");
+      } else if (!strcmp(argv[k] + 2, "container")) {
+        ct = 1;
+      } else if (!strcmp(argv[k] + 2, "numa")) {
+        nu = 1;
+      } else if (!strcmp(argv[k] + 2, "stats")) {
+        Stats.on = 1;
+      } else if (!strcmp(argv[k] + 2, "mmap")) {
+        mm = 1;
+      } else if (!strcmp(argv[k] + 2, "coef")) {
+        cf = 1;
+      } else if (!strcmp(argv[k] + 2, "poly")) {
+        py = 1;
+      } else if (!strncmp(argv[k] + 2, "chunk=", 6)) {
+        if (!(cs = strtoul(argv[k] + 8, 0, 10)))
+          error("Bad chunk size.");
+      } else
+        error("Unknown option.");
+      continue;
+    }
     p = 0;
     for (l = 0; argv[k][l] >= '0' && argv[k][l] <= '9'; ++l) {
       p = p * 10 + (argv[k][l] - '0');
@@ -187,44 +1326,16 @@ main(
       for (m = 0; m < in; ++m)
         if (*(ip + m) == p)
           error("Duplicate input point.");
-      if (!(v = realloc(ip, (in + 1) * sizeof (*ip))))
-        error("realloc.");
-      ip = v;
       *(ip + in) = p;
-      if (!(v = realloc(iv, (in + 1) * sizeof (*iv))))
-        error("realloc.");
-      iv = v;
-      if ((p = open(argv[k] + l + 1, O_RDONLY)) < 0)
+      if ((*(id + in) = open(argv[k] + l + 1, O_RDONLY)) < 0)
         error("Failed to open input file.");
-      s = lseek(p, 0, SEEK_END);
-      if (!ln)
-        ln = s;
-      else if (ln > s)
-        error("an input file is too small.");
-      if (!(*(iv + in) = malloc(ln)))
-        error("malloc.");
-      lseek(p, 0, SEEK_SET);
-      if (read(p, *(iv + in), ln) != ln)
-        error("read.");
-      close(p);
       ++in;
     } else if (argv[k][l] == '+') {
-      if (!ln)
+      if (!in)
         error("Specify an input before outputs.");
       if (on >= 256)
         error("Too many output points.");
-      if (!(v = realloc(op, (on + 1) * sizeof (*op))))
-        error("realloc.");
-      op = v;
       *(op + on) = p;
-      if (!(v = realloc(ov, (on + 1) * sizeof (*ov))))
-        error("realloc.");
-      ov = v;
-      if (!(*(ov + on) = malloc(ln)))
-        error("malloc.");
-      if (!(v = realloc(of, (on + 1) * sizeof (*of))))
-        error("realloc.");
-      of = v;
       *(of + on) = argv[k] + l + 1;
       ++on;
     } else
@@ -232,17 +1343,242 @@ main(
   }
   if (!in)
    error("No input files.");
-  if (!on)
+  if (!on && !ck)
    error("No output files.");
-  sss(ip, op, iv, ov, in, on, ln);
-  for (k = 0; k < on; ++k) {
+  if (on && ck)
+   error("No output files with --check.");
+  vn = in;
+  if ((tm != 0) + (rs != 0) + (ck != 0) + (dn != 0) > 1)
+    error("--threshold, --reshare, --check and --decode are exclusive.");
+  if (ck && ck >= in)
+    error("--check needs more than M shares.");
+  if (tm) {
     int p;
 
-    if ((p = open(*(of + k), O_CREAT | O_TRUNC | O_WRONLY, S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH)) < 0)
-      error("Failed to open output file.");
-    if (write(p, *(ov + k), ln) != ln)
-      error("write.");
+    if (in != 1)
+      error("Only the secret is input with --threshold.");
+    for (p = 0; in < tm; ++p)
+      if (p != *ip)
+        *(ip + in++) = p;
+  } else if (py)
+    for (k = 0; k < in; ++k)
+      if (*(ip + k) != k)
+        error("The coefficients are at points 0 to M-1 in order.");
+  if (cf) {
+    if (on != in || py || tm || rs || ck || dn)
+      error("--coef has as many outputs as inputs and no other options.");
+    for (k = 0; k < on; ++k)
+      if (*(op + k) != k)
+        error("The coefficients are at points 0 to M-1 in order.");
+  }
+  if (tm || rs) {
+    int p;
+
+    if ((p = open("/dev/urandom", O_RDONLY)) < 0 || fill(p, ky, sizeof (ky)) != sizeof (ky))
+      error("Failed to read /dev/urandom.");
     close(p);
   }
+  if (dn ? sssPlanDecode(&dc, ip, op, in, dn, on)
+   : ck ? sssPlanCheck(&pl, ip, in, ck)
+   : rs ? sssPlanReshare(&pl, ip, op, in, rs, on)
+   : cf ? sssPlanCoef(&pl, ip, in)
+   : py ? sssPlanPoly(&pl, op, in, on) : sssPlan(&pl, ip, op, in, on))
+    error("sssPlan.");
+  vf.ip = ip;
+  vf.a = vf.b = 0;
+  vf.v = 0;
+  vf.bad = 0;
+  ue = 0;
+  memset(is, 0, sizeof (is));
+  memset(os, 0, sizeof (os));
+  /* the shares must be of one value, at their points and enough of them */
+  tn = 0;
+  ps = ~0ULL; /* length, if known */
+  for (k = 0; ct && k < vn; ++k) {
+    if (!*(ip + k))
+      continue;
+    if (!(*(is + k) = malloc(sizeof (**is))))
+      error("malloc.");
+    openShare(*(is + k), *(id + k));
+    if ((*(is + k))->pt != *(ip + k))
+      error("A share is not at its point.");
+    if (!tn)
+      tn = (*(is + k))->tn;
+    if (ps == ~0ULL)
+      ps = (*(is + k))->ln;
+    if ((*(is + k))->tn != tn || ((*(is + k))->ln != ~0ULL && (*(is + k))->ln != ps))
+      error("The shares are not of one value.");
+  }
+  if (vn < tn)
+    error("Too few shares.");
+  /* new shares need as many as the inputs, unless given */
+  tn = tm ? tm : rs ? rs : tn ? tn : in;
+  for (k = 0; ct && k < on; ++k) {
+    if (!*(op + k))
+      continue;
+    if (cs > 0xffffffff)
+      error("Bad chunk size.");
+    if (!(*(os + k) = malloc(sizeof (**os))))
+      error("malloc.");
+    (*(os + k))->pt = *(op + k);
+    (*(os + k))->tn = tn;
+    (*(os + k))->cs = cs;
+  }
+  if (ct && mm)
+    error("--container does not work with --mmap.");
+  if (nu && th < 2)
+    error("--numa needs --threads.");
+  /* only the plain computation and splits are threaded, those without --numa */
+  if (tm || rs || ck || dn)
+    nu = 0;
+  if (th > 1)
+    poolInit(&pool, th, nu);
+  /* only the range is read */
+  for (k = 0; ra && !mm && k < vn; ++k)
+    if (*(is + k))
+      seekShare(*(is + k), ra);
+    else if (lseek(*(id + k), ra, SEEK_SET) == (off_t)-1)
+      error("--range needs inputs that can be seeked.");
+  if (mm) {
+    struct stat st;
+
+    /* the first input sets the length, the outputs are sized to it */
+    for (k = 0; k < vn; ++k) {
+      if (fstat(*(id + k), &st) || !S_ISREG(st.st_mode))
+        error("Only regular files can be mapped.");
+      if (!k) {
+        ps = (unsigned long long)st.st_size < rb ? (unsigned long long)st.st_size : rb;
+        ps = ps > ra ? ps - ra : 0;
+        if (ps > (size_t)~0)
+          error("an input file is too large.");
+        ln = ps;
+      } else if (ln && (unsigned long long)st.st_size < ra + ln)
+        error("an input file is too small.");
+      if (ln)
+        *(iv + k) = map(*(id + k), ra, ln, PROT_READ);
+    }
+    for (k = 0; k < on; ++k) {
+      if ((*(od + k) = open(*(of + k), O_CREAT | O_TRUNC | O_RDWR, S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH)) < 0)
+        error("Failed to open output file.");
+      if (ftruncate(*(od + k), ln))
+        error("ftruncate.");
+      if (ln)
+        *(ov + k) = map(*(od + k), 0, ln, PROT_READ | PROT_WRITE);
+    }
+    if (nu)
+      place(&pool, &pl, iv, ov, 0);
+    if (ln)
+      ue += compute(&pl, th > 1 ? &pool : 0, tm || rs ? ky : 0, ck ? &vf : 0, dn ? &dc : 0
+       ,iv, ov, vn, ra, ln);
+    for (k = 0; ln && k < on; ++k)
+      if (munmap(*(ov + k), ln))
+        error("munmap.");
+  } else if (pp) {
+    struct pipeline p;
+    struct slot *s;
+    pthread_t rt;
+    pthread_t wt;
+    unsigned int n;
+    size_t bs;
+
+    pthread_mutex_init(&p.mx, 0);
+    pthread_cond_init(&p.cv, 0);
+    p.id = id;
+    p.od = od;
+    p.is = is;
+    p.os = os;
+    p.vn = vn;
+    p.on = on;
+    p.cs = cs;
+    p.ps = ra;
+    p.rm = rb - ra;
+    bs = cs;
+    ab = arena(3 * (vn + on), &bs, nu);
+    for (n = 0; n < 3; ++n) {
+      s = p.sl + n;
+      s->st = 0;
+      for (k = 0; k < vn; ++k)
+        *(s->iv + k) = ab + (n * (vn + on) + k) * bs;
+      for (k = 0; k < on; ++k)
+        *(s->ov + k) = ab + (n * (vn + on) + vn + k) * bs;
+      if (nu)
+        place(&pool, &pl, s->iv, s->ov, cs);
+    }
+    for (k = 0; k < on; ++k) {
+      if ((*(od + k) = open(*(of + k), O_CREAT | O_TRUNC | O_WRONLY, S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH)) < 0)
+        error("Failed to open output file.");
+      if (*(os + k))
+        createShare(*(os + k), *(od + k));
+    }
+    if (pthread_create(&rt, 0, reader, &p) || pthread_create(&wt, 0, writer, &p))
+      error("pthread_create.");
+    for (n = 0;; ++n) {
+      s = await(&p, n, 1);
+      /* once posted the slot can come around again */
+      if (!(ln = s->ln)) {
+        post(&p, s, 2);
+        break;
+      }
+      ue += compute(&pl, th > 1 ? &pool : 0, tm || rs ? ky : 0, ck ? &vf : 0, dn ? &dc : 0
+       ,s->iv, s->ov, vn, s->ps, ln);
+      post(&p, s, 2);
+    }
+    pthread_join(rt, 0);
+    pthread_join(wt, 0);
+  } else {
+    size_t bs;
+
+    bs = cs;
+    ab = arena(vn + on, &bs, nu);
+    for (k = 0; k < vn; ++k)
+      *(iv + k) = ab + k * bs;
+    for (k = 0; k < on; ++k)
+      *(ov + k) = ab + (vn + k) * bs;
+    if (nu)
+      place(&pool, &pl, iv, ov, cs);
+    for (k = 0; k < on; ++k) {
+      if ((*(od + k) = open(*(of + k), O_CREAT | O_TRUNC | O_WRONLY, S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH)) < 0)
+        error("Failed to open output file.");
+      if (*(os + k))
+        createShare(*(os + k), *(od + k));
+    }
+    /* the first input sets the length, a chunk at a time */
+    for (ps = ra; (ln = input(*is, *id, *iv, cs < rb - ps ? cs : rb - ps)); ps += ln) {
+      for (k = 1; k < vn; ++k)
+        if (input(*(is + k), *(id + k), *(iv + k), ln) != ln)
+          error("an input file is too small.");
+      ue += compute(&pl, th > 1 ? &pool : 0, tm || rs ? ky : 0, ck ? &vf : 0, dn ? &dc : 0
+       ,iv, ov, vn, ps, ln);
+      for (k = 0; k < on; ++k)
+        output(*(os + k), *(od + k), *(ov + k), ln);
+    }
+  }
+  memset(ky, 0, sizeof (ky));
+  free(ab);
+  for (k = 0; k < vn; ++k)
+    if (*(is + k)) {
+      free((*(is + k))->cb);
+      free(*(is + k));
+    }
+  /* checks and decodes are computed by this thread alone, see compute */
+  if (Stats.on)
+    report(ck || dn ? 1 : th);
+  if (ue) {
+    fprintf(stderr, "%llu bytes could not be decoded.\n", ue);
+    exit(EXIT_FAILURE);
+  }
+  if (ck) {
+    result(&vf, vf.b + 1, 0, 0);
+    if (vf.bad)
+      exit(EXIT_FAILURE);
+  }
+  for (k = 0; k < on; ++k) {
+    if (*(os + k)) {
+      closeShare(*(os + k));
+      free(*(os + k));
+    }
+    if (close(*(od + k)))
+      error("close.");
+  }
   return (0);
 }